@@ -3,6 +3,7 @@
 #define HW1_BST_H
 
 #include <exception>
+#include <iterator>
 #include <new>
 #include <stddef.h>
 #include <cassert>
@@ -16,20 +17,74 @@
 
 namespace trees {
 
+    /**THREE WAY COMPARE
+     * the default order of a tree's keys, by their < operator. Branch free
+     * for integral keys.
+     * @return negative if first < second, 0 if they are equal, positive if
+     *         first > second */
+    template<class Key>
+    class ThreeWayCompare {
+    public:
+        int operator()(const Key& first, const Key& second) const {
+            return (int) (second < first) - (int) (first < second);
+        }
+    };
+
+    /**STORED KEY
+     * the default key policy of a tree: every node keeps a copy of the key
+     * it was inserted with */
+    template<class T, class Key>
+    class StoredKey {
+        Key key;
+    public:
+        StoredKey(const T&, const Key& key) : key(key) {}
+
+        Key keyOf(const T&) const {
+            return key;
+        }
+
+        void setKey(const Key& key) {
+            this->key = key;
+        }
+    };
+
+    /**EXTRACTED KEY
+     * a key policy for data that carries its own key: the nodes store no
+     * key, it is taken from the data by Extract whenever it is compared.
+     * Extract is an empty base, so it adds nothing to a node.
+     * @tparam Extract - function object with Key operator()(const T&) const.
+     *                   The key given to insert must be the one it returns */
+    template<class T, class Key, class Extract>
+    class ExtractedKey : private Extract {
+    public:
+        ExtractedKey(const T&, const Key&) {}
+
+        Key keyOf(const T& data) const {
+            return Extract::operator()(data);
+        }
+
+        void setKey(const Key&) {}
+    };
+
     /**BINARY SEARCH TREE
      * @tparam T - Type of data the tree would keep
      * @tparam Key - The key by which the tree will be sorted
-     *               Key should overload comparision operators <,>,= */
-    template<class T, class Key>
+     * @tparam Compare - function object with a three way
+     *                   int operator()(const Key&, const Key&), see
+     *                   ThreeWayCompare. It is called once per visited node.
+     *                   By default Key should overload operator <
+     * @tparam KeyOf - where a node's key comes from: StoredKey (default)
+     *                 or ExtractedKey */
+    template<class T, class Key, class Compare = ThreeWayCompare<Key>,
+             class KeyOf = StoredKey<T, Key> >
     class BST {
 
     protected:
-        struct Node {
+        struct Node : public KeyOf {
             T data;
-            Key key;
             int size_of_sub_tree;
-            int weight;
-            int value;
+            int value; //next to size_of_sub_tree, so neither is padded
+            long long weight;
             Node* parent;
             Node* left_son;
             Node* right_son;
@@ -38,10 +93,15 @@ namespace trees {
              * @param data - The node data
              * @param key - unique key by which the node should be placed. */
             Node(const T& data, const Key& key, int value);
+
+            Key getKey() const {
+                return this->keyOf(data);
+            }
         };
 
         Node* root; //tree's root
         int size;
+        unsigned long version; //bumped by every change of the keys or values
 
         /**FIND MIN
          * finding the min (by key) node in ptr's sub-tree
@@ -56,7 +116,7 @@ namespace trees {
         Node* findMaxRec(Node* ptr);
 
         /**FIND REC
-         * recursive helper function for find.
+         * helper function for find, a loop down the tree.
          * finding node with key in current's sub-tree.
          * @param key - the key we are searching
          * @param current - the current root's node
@@ -71,6 +131,42 @@ namespace trees {
 
         void update_ranks(Node* n);
 
+        /**LINK BALANCED
+         * links the nodes [first, end) of a key sorted array into a balanced
+         * sub-tree and updates their ranks. O(end - first).
+         * @param nodes - sorted by key
+         * @param parent - the parent of the new sub-tree
+         * @return the new sub-tree's root, or NULL if the range is empty */
+        Node* linkBalanced(Node** nodes, int first, int end, Node* parent);
+
+        /**TO VINE
+         * turns the sub-tree of ptr into a list linked through right_son, in
+         * increasing key order, by right rotations. O(n), no allocation.
+         * parent, left_son and the ranks of the nodes are left stale.
+         * @return the first node of the list */
+        static Node* toVine(Node* ptr);
+
+        /**LINK LIST
+         * links the next n nodes of a right_son linked sorted list into a
+         * balanced sub-tree and updates their ranks. O(n), no allocation.
+         * @param head - the list's first node, advanced past the n nodes
+         * @param parent - the parent of the new sub-tree
+         * @return the new sub-tree's root, or NULL if n is 0 */
+        Node* linkList(Node** head, int n, Node* parent);
+
+        /**DESCEND PREFIX
+         * sums the values of the k smallest keys in a single descent
+         * @param k - 0 <= k <= size
+         * @param sum - the sum will be put in sum
+         * @return the last node visited, or NULL if the tree is empty */
+        Node* descendPrefix(int k, long long* sum);
+
+        /**DESCEND COUNT LESS
+         * counts the keys smaller than key in a single descent
+         * @param count - the count will be put in count
+         * @return the last node visited, or NULL if the tree is empty */
+        Node* descendCountLess(const Key& key, int* count);
+
     private:
         /**COPY REC
          * recursive helper function for copy
@@ -80,8 +176,8 @@ namespace trees {
         Node* copyRec(const Node* ptr, Node* new_node_parent);
 
         /**DELETE REC
-         * recursive helper function for deleting the tree
-         * delete ptr sub-trees and then delete ptr itself
+         * helper function for deleting the tree
+         * delete ptr sub-trees and ptr itself, in O(n) without recursion
          * @param ptr - the current node to delete.  */
         void deleteRec(Node* ptr);
 
@@ -98,6 +194,12 @@ namespace trees {
         template<class Func>
         void inorderDataRec(Func& function, Node* p);
 
+        /**INORDER REC
+         * the read only version, operating on const data.
+         * @param p - the current node of the tree */
+        template<class Func>
+        void inorderDataRec(Func& function, const Node* p) const;
+
         /**REVERSE INORDER REC
          * recursive helper for inorder fucdtion. operating on data.
          * @param p - the current node of the tree */
@@ -153,6 +255,14 @@ namespace trees {
          */
         virtual T remove(const Key& key);
 
+        /**UPDATE
+         * replaces the data and value of key's node. The node keeps its place,
+         * so nothing is allocated.
+         * @param key - the key of the node to update
+         * @exception KeyNotFound - there is no node with the wanted key in tree
+         */
+        virtual void update(const Key& key, const T& data, int value);
+
         /**FIND MAX
          * finding the max in the tree by key and return its data
          * @return the data of max
@@ -172,6 +282,14 @@ namespace trees {
         template<class Func>
         void inorderData(Func& function);
 
+        /**INORDER
+         * apply the function on each tree's data by inorder, without
+         * modifying it
+         * @tparam Func - function object that overload operator() and has one
+         *                parameter of type const T& */
+        template<class Func>
+        void inorderData(Func& function) const;
+
 
         /**INORDER ON DATA AND KEY
          * apply the function on each tree's data and key by inorder
@@ -189,6 +307,43 @@ namespace trees {
         template<class Func>
         void reverseInorder(Func& function);
 
+        /**BUILD FROM SORTED
+         * replaces the content of the tree with n nodes given in increasing
+         * key order. The tree is built balanced, with its ranks, in O(n)
+         * without any comparison besides checking the order.
+         * @param data - data of each node
+         * @param keys - key of each node, strictly increasing
+         * @param values - value of each node
+         * @param n - number of nodes
+         * @exception InvalidInput - the keys aren't strictly increasing */
+        void buildFromSorted(const T* data, const Key* keys, const int* values,
+                             int n);
+
+        /**ABSORB
+         * moves all the nodes of tree into this tree, leaving tree empty.
+         * Both trees are flattened in key order, merged, and relinked into a
+         * balanced tree in O(n + m). The nodes are moved, not copied, and
+         * nothing is allocated.
+         * @param tree - another tree, emptied
+         * @exception KeyAlreadyExist - a key is in both trees. Both are
+         *                              checked first and left unchanged */
+        void absorb(BST& tree);
+
+        /**---------------------------ITERATION-------------------------
+         * Bidirectional iterators over the data, by increasing key. They
+         * point to nodes, so they stay valid while a splay tree rotates, but
+         * insert and remove invalidate them. A const tree only hands out
+         * const data. Dereferencing end() is checked in debug builds only. */
+        template<class DataType>
+        class NodeIterator;
+        typedef NodeIterator<T> Iterator;
+        typedef NodeIterator<const T> ConstIterator;
+
+        Iterator begin();
+        Iterator end();
+        ConstIterator begin() const;
+        ConstIterator end() const;
+
         /**GET ROOT
          * @return the root's data
          * @exceptopn TreeIsEmpty if tree is empty */
@@ -198,11 +353,32 @@ namespace trees {
          * @return the size of the tree */
         int getSize() const;
 
+        /**GET VERSION
+         * @return a counter that changes whenever a key, a data or a value
+         *         of the tree changes (insert, remove, update, absorb,
+         *         build, assignment). Splaying doesn't change it, so equal
+         *         versions mean equal query results */
+        unsigned long getVersion() const;
+
         //TODO DESCRIPTION
         virtual Key select(int k);
 
         //TODO virtual int rank_weight(Key x);
 
+        /**PREFIX WEIGHT
+         * sums the values of the k smallest keys, using the subtree weights,
+         * in a single descent
+         * @param k - number of keys, 0 <= k <= size
+         * @return the sum of their values
+         * @exception InvalidInput - k is out of range */
+        virtual long long prefixWeight(int k);
+
+        /**COUNT LESS
+         * counts the keys smaller than key, in a single descent. key doesn't
+         * have to be in the tree.
+         * @return number of smaller keys */
+        virtual int countLess(const Key& key);
+
         /**-------------ERRORS--------------------------------------**/
         class TreeException : public std::exception {
         };
@@ -226,51 +402,60 @@ namespace trees {
         };
     };
 
-    template<class T, class Key>
-    BST<T, Key>::BST(): root(NULL), size(0) {}
+    template<class T, class Key, class Compare, class KeyOf>
+    BST<T, Key, Compare, KeyOf>::BST(): root(NULL), size(0), version(0) {}
 
-    template<class T, class Key>
-    BST<T, Key>::BST(const T& root_data, const Key& key, int value):
-            root(new Node(root_data, key, value)), size(1) {}
+    template<class T, class Key, class Compare, class KeyOf>
+    BST<T, Key, Compare, KeyOf>::BST(const T& root_data, const Key& key, int value):
+            root(new Node(root_data, key, value)), size(1), version(0) {}
 
-    template<class T, class Key>
-    BST<T, Key>::~BST() {
+    template<class T, class Key, class Compare, class KeyOf>
+    BST<T, Key, Compare, KeyOf>::~BST() {
         if (root != NULL) {
             deleteRec(root);
         }
     }
 
-    template<class T, class Key>
-    BST<T, Key>& BST<T, Key>::operator=(const BST& tree) {
-        Node* saved = this->root;
-        try {
-            this->root = copyRec(tree.root, NULL);
-        } catch (std::bad_alloc&) {
-            this->root = saved;
-            throw std::bad_alloc();
-        }
+    template<class T, class Key, class Compare, class KeyOf>
+    BST<T, Key, Compare, KeyOf>& BST<T, Key, Compare, KeyOf>::operator=(const BST& tree) {
+        if (this == &tree)
+            return *this;
+        Node* copy = copyRec(tree.root, NULL);
         deleteRec(this->root);
+        this->root = copy;
+        this->size = tree.size;
+        this->version++;
         return *this;
     }
 
-    template<class T, class Key>
-    void BST<T, Key>::deleteRec(Node* ptr) {
-        if (ptr == NULL) return;
-        deleteRec(ptr->left_son);
-        deleteRec(ptr->right_son);
-        delete ptr;
+    template<class T, class Key, class Compare, class KeyOf>
+    void BST<T, Key, Compare, KeyOf>::deleteRec(Node* ptr) {
+        //rotates left sons up instead of recursing, a splay tree may be a
+        //path deeper than the stack
+        while (ptr) {
+            if (ptr->left_son) {
+                Node* left = ptr->left_son;
+                ptr->left_son = left->right_son;
+                left->right_son = ptr;
+                ptr = left;
+            } else {
+                Node* next = ptr->right_son;
+                delete ptr;
+                ptr = next;
+            }
+        }
     }
 
-    template<class T, class Key>
-    BST<T, Key>::BST(const BST& tree) : size(tree.size) {
+    template<class T, class Key, class Compare, class KeyOf>
+    BST<T, Key, Compare, KeyOf>::BST(const BST& tree) : size(tree.size), version(0) {
         this->root = copyRec(tree.root, NULL);
     }
 
-    template<class T, class Key>
-    typename BST<T, Key>::Node*
-    BST<T, Key>::copyRec(const Node* ptr, Node* new_node_parent) {
+    template<class T, class Key, class Compare, class KeyOf>
+    typename BST<T, Key, Compare, KeyOf>::Node*
+    BST<T, Key, Compare, KeyOf>::copyRec(const Node* ptr, Node* new_node_parent) {
         if (ptr == NULL) return NULL;
-        Node* new_root = new Node(ptr->data, ptr->key, ptr->value);
+        Node* new_root = new Node(ptr->data, ptr->getKey(), ptr->value);
         new_root->weight = ptr->weight;
         new_root->size_of_sub_tree = ptr->size_of_sub_tree;
         new_root->parent = new_node_parent;
@@ -279,42 +464,39 @@ namespace trees {
         return new_root;
     }
 
-    template<class T, class Key>
-    T& BST<T, Key>::find(const Key& key) {
+    template<class T, class Key, class Compare, class KeyOf>
+    T& BST<T, Key, Compare, KeyOf>::find(const Key& key) {
         Node* res = NULL;
         if (findRec(key, root, &res))
             return res->data;
         throw KeyNotFound(key);
     }
 
-    template<class T, class Key>
-    bool BST<T, Key>::findRec(const Key& key, Node* current, Node** res) {
-        if (current == NULL) {
-            *res = NULL;
-            return false;
-        }
-        if (current->key == key) { //key founded
+    template<class T, class Key, class Compare, class KeyOf>
+    bool BST<T, Key, Compare, KeyOf>::findRec(const Key& key, Node* current, Node** res) {
+        *res = NULL;
+        while (current) {
+            //current is the parent where key should have been, so far
             *res = current;
-            return true;
+            int order = Compare()(key, current->getKey());
+            if (order == 0) //key founded
+                return true;
+            if (order < 0) //search left tree
+                current = current->left_son;
+            else           //search right tree
+                current = current->right_son;
         }
-        bool found;
-        if (current->key > key) //search left tree
-            found = findRec(key, current->left_son, res);
-        else                    //search right tree
-            found = findRec(key, current->right_son, res);
-        if (*res == NULL) //current is the parent where key should have been
-            *res = current;
-        return found;
+        return false;
     }
 
-    template<class T, class Key>
-    void BST<T, Key>::insert(const T& data, const Key& key, int value) {
+    template<class T, class Key, class Compare, class KeyOf>
+    void BST<T, Key, Compare, KeyOf>::insert(const T& data, const Key& key, int value) {
         Node* new_node_parent = NULL;
         if (findRec(key, root, &new_node_parent))
             throw KeyAlreadyExist(key);
         //new_node_parent is the parent of the node that should be added
         if (new_node_parent) {
-            if (key < new_node_parent->key) {
+            if (Compare()(key, new_node_parent->getKey()) < 0) {
                 new_node_parent->left_son = new Node(data, key, value);
                 new_node_parent->left_son->parent = new_node_parent;
             } else {
@@ -326,10 +508,11 @@ namespace trees {
             root = new Node(data, key, value);
         }
         size++;
+        version++;
     }
 
-    template<class T, class Key>
-    typename BST<T, Key>::Node* BST<T, Key>::findMinRec(Node* ptr) {
+    template<class T, class Key, class Compare, class KeyOf>
+    typename BST<T, Key, Compare, KeyOf>::Node* BST<T, Key, Compare, KeyOf>::findMinRec(Node* ptr) {
         if (ptr == NULL)
             return NULL;
         while (ptr->left_son)
@@ -337,8 +520,8 @@ namespace trees {
         return ptr;
     }
 
-    template<class T, class Key>
-    typename BST<T, Key>::Node* BST<T, Key>::findMaxRec(Node* ptr) {
+    template<class T, class Key, class Compare, class KeyOf>
+    typename BST<T, Key, Compare, KeyOf>::Node* BST<T, Key, Compare, KeyOf>::findMaxRec(Node* ptr) {
         if (ptr == NULL)
             return NULL;
         while (ptr->right_son)
@@ -347,8 +530,8 @@ namespace trees {
     }
 
 
-    template<class T, class Key>
-    T BST<T, Key>::remove(const Key& key) {
+    template<class T, class Key, class Compare, class KeyOf>
+    T BST<T, Key, Compare, KeyOf>::remove(const Key& key) {
         Node* to_delete = NULL;
         if (!findRec(key, root, &to_delete))
             throw KeyNotFound(key);
@@ -358,7 +541,7 @@ namespace trees {
             to_delete->right_son != NULL) {
             Node* next = findMinRec(to_delete->right_son);
             to_delete->data = next->data;
-            to_delete->key = next->key;
+            to_delete->setKey(next->getKey());
             to_delete->value = next->value;
             delete next;
             Node* new_next = findMinRec(to_delete->right_son);
@@ -385,91 +568,242 @@ namespace trees {
             update_ranks_to_the_top(to_delete_parent);
         }
         size--;
+        version++;
         return deleted_data;
     }
 
-    template<class T, class Key>
-    T BST<T, Key>::findMin() {
+    template<class T, class Key, class Compare, class KeyOf>
+    void BST<T, Key, Compare, KeyOf>::update(const Key& key, const T& data, int value) {
+        Node* node = NULL;
+        if (!findRec(key, root, &node))
+            throw KeyNotFound(key);
+        node->data = data;
+        node->value = value;
+        update_ranks_to_the_top(node);
+        version++;
+    }
+
+    template<class T, class Key, class Compare, class KeyOf>
+    T BST<T, Key, Compare, KeyOf>::findMin() {
         Node* result = findMinRec(root);
         if (result)
             return result->data;
         throw TreeIsEmpty();
     }
 
-    template<class T, class Key>
-    T BST<T, Key>::findMax() {
+    template<class T, class Key, class Compare, class KeyOf>
+    T BST<T, Key, Compare, KeyOf>::findMax() {
         Node* result = findMaxRec(root);
         if (result)
             return result->data;
         throw TreeIsEmpty();
     }
 
-    template<class T, class Key>
+    template<class T, class Key, class Compare, class KeyOf>
     template<class Func>
-    void BST<T, Key>::inorderData(Func& function) {
+    void BST<T, Key, Compare, KeyOf>::inorderData(Func& function) {
         inorderDataRec(function, root);
     }
 
-    template<class T, class Key>
+    template<class T, class Key, class Compare, class KeyOf>
     template<class Func>
-    void BST<T, Key>::inorderDataRec(Func& function, Node* p) {
+    void BST<T, Key, Compare, KeyOf>::inorderDataRec(Func& function, Node* p) {
         if (p == NULL) return;
         inorderDataRec(function, p->left_son);
         function(p->data);
         inorderDataRec(function, p->right_son);
     }
 
-    template<class T, class Key>
+    template<class T, class Key, class Compare, class KeyOf>
     template<class Func>
-    void BST<T, Key>::inorderDataAndKey(Func& function) {
+    void BST<T, Key, Compare, KeyOf>::inorderData(Func& function) const {
+        inorderDataRec(function, root);
+    }
+
+    template<class T, class Key, class Compare, class KeyOf>
+    template<class Func>
+    void BST<T, Key, Compare, KeyOf>::inorderDataRec(Func& function, const Node* p) const {
+        if (p == NULL) return;
+        inorderDataRec(function, p->left_son);
+        function(p->data);
+        inorderDataRec(function, p->right_son);
+    }
+
+    template<class T, class Key, class Compare, class KeyOf>
+    template<class Func>
+    void BST<T, Key, Compare, KeyOf>::inorderDataAndKey(Func& function) {
         inorderDataAndKeyRec(function, root);
     }
 
-    template<class T, class Key>
+    template<class T, class Key, class Compare, class KeyOf>
     template<class Func>
-    void BST<T, Key>::inorderDataAndKeyRec(Func& function, Node* p) {
+    void BST<T, Key, Compare, KeyOf>::inorderDataAndKeyRec(Func& function, Node* p) {
         if (p == NULL) return;
         inorderDataAndKeyRec(function, p->left_son);
-        function(p->data, p->key);
+        function(p->data, p->getKey());
         inorderDataAndKeyRec(function, p->right_son);
     }
 
-    template<class T, class Key>
+    template<class T, class Key, class Compare, class KeyOf>
     template<class Func>
-    void BST<T, Key>::reverseInorder(Func& function) {
+    void BST<T, Key, Compare, KeyOf>::reverseInorder(Func& function) {
         reverseInorderRec(function, root);
     }
 
-    template<class T, class Key>
+    template<class T, class Key, class Compare, class KeyOf>
     template<class Func>
-    void BST<T, Key>::reverseInorderRec(Func& function, Node* p) {
+    void BST<T, Key, Compare, KeyOf>::reverseInorderRec(Func& function, Node* p) {
         if (p == NULL) return;
         reverseInorderRec(function, p->right_son);
         function(p->data);
         reverseInorderRec(function, p->left_son);
     }
 
-    template<class T, class Key>
-    T BST<T, Key>::getRoot() const {
+    template<class T, class Key, class Compare, class KeyOf>
+    typename BST<T, Key, Compare, KeyOf>::Node*
+    BST<T, Key, Compare, KeyOf>::linkBalanced(Node** nodes, int first, int end, Node* parent) {
+        if (first >= end)
+            return NULL;
+        int middle = first + (end - first) / 2;
+        Node* sub_root = nodes[middle];
+        sub_root->parent = parent;
+        sub_root->left_son = linkBalanced(nodes, first, middle, sub_root);
+        sub_root->right_son = linkBalanced(nodes, middle + 1, end, sub_root);
+        update_ranks(sub_root);
+        return sub_root;
+    }
+
+    template<class T, class Key, class Compare, class KeyOf>
+    void BST<T, Key, Compare, KeyOf>::buildFromSorted(const T* data, const Key* keys,
+                                      const int* values, int n) {
+        if (n < 0)
+            throw InvalidInput();
+        for (int i = 1; i < n; i++) {
+            if (Compare()(keys[i - 1], keys[i]) >= 0)
+                throw InvalidInput();
+        }
+        Node** nodes = new Node* [n > 0 ? n : 1];
+        int created = 0;
+        try {
+            for (; created < n; created++)
+                nodes[created] = new Node(data[created], keys[created],
+                                          values[created]);
+        } catch (std::bad_alloc&) {
+            for (int i = 0; i < created; i++)
+                delete nodes[i];
+            delete[] nodes;
+            throw;
+        }
+        deleteRec(root);
+        root = linkBalanced(nodes, 0, n, NULL);
+        size = n;
+        version++;
+        delete[] nodes;
+    }
+
+    template<class T, class Key, class Compare, class KeyOf>
+    typename BST<T, Key, Compare, KeyOf>::Node*
+    BST<T, Key, Compare, KeyOf>::toVine(Node* ptr) {
+        Node* head = ptr;
+        Node** link = &head; //the pointer to the current node
+        while (ptr) {
+            if (ptr->left_son == NULL) {
+                link = &ptr->right_son;
+                ptr = ptr->right_son;
+                continue;
+            }
+            //rotate the left son up, until the current node has none
+            Node* left = ptr->left_son;
+            ptr->left_son = left->right_son;
+            left->right_son = ptr;
+            ptr = left;
+            *link = left;
+        }
+        return head;
+    }
+
+    template<class T, class Key, class Compare, class KeyOf>
+    typename BST<T, Key, Compare, KeyOf>::Node*
+    BST<T, Key, Compare, KeyOf>::linkList(Node** head, int n, Node* parent) {
+        if (n == 0)
+            return NULL;
+        Node* left = linkList(head, n / 2, NULL);
+        Node* sub_root = *head;
+        *head = sub_root->right_son;
+        sub_root->parent = parent;
+        sub_root->left_son = left;
+        if (left)
+            left->parent = sub_root;
+        sub_root->right_son = linkList(head, n - n / 2 - 1, sub_root);
+        update_ranks(sub_root);
+        return sub_root;
+    }
+
+    template<class T, class Key, class Compare, class KeyOf>
+    void BST<T, Key, Compare, KeyOf>::absorb(BST& tree) {
+        if (this == &tree || tree.root == NULL)
+            return;
+        //both in order at once, before anything is moved
+        ConstIterator mine = static_cast<const BST&>(*this).begin();
+        ConstIterator theirs = static_cast<const BST&>(tree).begin();
+        while (mine.current && theirs.current) {
+            int order = Compare()(mine.current->getKey(), theirs.current->getKey());
+            if (order == 0)
+                throw KeyAlreadyExist(mine.current->getKey());
+            if (order < 0)
+                ++mine;
+            else
+                ++theirs;
+        }
+
+        Node* first = toVine(root);
+        Node* second = toVine(tree.root);
+        Node* merged = NULL;
+        Node** link = &merged;
+        while (first && second) {
+            if (Compare()(first->getKey(), second->getKey()) < 0) {
+                *link = first;
+                first = first->right_son;
+            } else {
+                *link = second;
+                second = second->right_son;
+            }
+            link = &(*link)->right_son;
+        }
+        *link = first ? first : second;
+
+        size += tree.size;
+        root = linkList(&merged, size, NULL);
+        tree.root = NULL;
+        tree.size = 0;
+        version++;
+        tree.version++;
+    }
+
+    template<class T, class Key, class Compare, class KeyOf>
+    T BST<T, Key, Compare, KeyOf>::getRoot() const {
         if (root == NULL) throw TreeIsEmpty();
         return root->data;
     }
 
-    template<class T, class Key>
-    int BST<T, Key>::getSize() const {
+    template<class T, class Key, class Compare, class KeyOf>
+    int BST<T, Key, Compare, KeyOf>::getSize() const {
         return size;
     }
 
-    template<class T, class Key>
-    void BST<T, Key>::update_ranks_to_the_top(Node* ptr) {
-        if (ptr == NULL)
-            return;
-        update_ranks(ptr);
-        update_ranks_to_the_top(ptr->parent);
+    template<class T, class Key, class Compare, class KeyOf>
+    unsigned long BST<T, Key, Compare, KeyOf>::getVersion() const {
+        return version;
     }
 
-    template<class T, class Key>
-    void BST<T, Key>::update_ranks(Node* n) {
+    template<class T, class Key, class Compare, class KeyOf>
+    void BST<T, Key, Compare, KeyOf>::update_ranks_to_the_top(Node* ptr) {
+        for (; ptr; ptr = ptr->parent)
+            update_ranks(ptr);
+    }
+
+    template<class T, class Key, class Compare, class KeyOf>
+    void BST<T, Key, Compare, KeyOf>::update_ranks(Node* n) {
         if (n == NULL)
             return;
         n->size_of_sub_tree = 1;
@@ -484,8 +818,8 @@ namespace trees {
         }
     }
 
-    template<class T, class Key>
-    Key BST<T, Key>::select(int k) {
+    template<class T, class Key, class Compare, class KeyOf>
+    Key BST<T, Key, Compare, KeyOf>::select(int k) {
         if (k > size || k <= 0)
             throw InvalidInput();
         Node* ptr = this->root;
@@ -494,7 +828,7 @@ namespace trees {
             if (ptr->left_son)
                 size_of_left = ptr->left_son->size_of_sub_tree;
             if (size_of_left == k - 1)
-                return ptr->key;
+                return ptr->getKey();
             if (size_of_left > k - 1) {
                 ptr = ptr->left_son;
             } else {
@@ -508,12 +842,203 @@ namespace trees {
         throw InvalidInput();
     }
 
+    template<class T, class Key, class Compare, class KeyOf>
+    typename BST<T, Key, Compare, KeyOf>::Node*
+    BST<T, Key, Compare, KeyOf>::descendPrefix(int k, long long* sum) {
+        assert(k >= 0 && k <= size);
+        *sum = 0;
+        Node* last = root;
+        Node* ptr = root;
+        while (ptr && k > 0) {
+            last = ptr;
+            int size_of_left = 0;
+            if (ptr->left_son)
+                size_of_left = ptr->left_son->size_of_sub_tree;
+            if (k <= size_of_left) {
+                ptr = ptr->left_son;
+                continue;
+            }
+            //all of the left sub-tree and ptr itself are taken
+            if (ptr->left_son)
+                *sum += ptr->left_son->weight;
+            *sum += ptr->value;
+            k -= size_of_left + 1;
+            ptr = ptr->right_son;
+        }
+        return last;
+    }
+
+    template<class T, class Key, class Compare, class KeyOf>
+    long long BST<T, Key, Compare, KeyOf>::prefixWeight(int k) {
+        if (k < 0 || k > size)
+            throw InvalidInput();
+        long long sum;
+        descendPrefix(k, &sum);
+        return sum;
+    }
+
+    template<class T, class Key, class Compare, class KeyOf>
+    typename BST<T, Key, Compare, KeyOf>::Node*
+    BST<T, Key, Compare, KeyOf>::descendCountLess(const Key& key, int* count) {
+        *count = 0;
+        Node* last = NULL;
+        Node* ptr = root;
+        while (ptr) {
+            last = ptr;
+            if (Compare()(ptr->getKey(), key) < 0) {
+                *count += 1;
+                if (ptr->left_son)
+                    *count += ptr->left_son->size_of_sub_tree;
+                ptr = ptr->right_son;
+            } else {
+                ptr = ptr->left_son;
+            }
+        }
+        return last;
+    }
+
+    template<class T, class Key, class Compare, class KeyOf>
+    int BST<T, Key, Compare, KeyOf>::countLess(const Key& key) {
+        int count;
+        descendCountLess(key, &count);
+        return count;
+    }
+
+    template<class T, class Key, class Compare, class KeyOf>
+    typename BST<T, Key, Compare, KeyOf>::Iterator BST<T, Key, Compare, KeyOf>::begin() {
+        return Iterator(this, findMinRec(root));
+    }
+
+    template<class T, class Key, class Compare, class KeyOf>
+    typename BST<T, Key, Compare, KeyOf>::Iterator BST<T, Key, Compare, KeyOf>::end() {
+        return Iterator(this, NULL);
+    }
+
+    template<class T, class Key, class Compare, class KeyOf>
+    typename BST<T, Key, Compare, KeyOf>::ConstIterator BST<T, Key, Compare, KeyOf>::begin() const {
+        return ConstIterator(this, const_cast<BST*>(this)->findMinRec(root));
+    }
+
+    template<class T, class Key, class Compare, class KeyOf>
+    typename BST<T, Key, Compare, KeyOf>::ConstIterator BST<T, Key, Compare, KeyOf>::end() const {
+        return ConstIterator(this, NULL);
+    }
+
+/*-------------------------------------------------------------*/
+/*--------------------------ITERATOR---------------------------*/
+    /**an in-order iterator. At the end it points to no node (NULL).
+     * @tparam DataType - T, or const T for a const tree */
+    template<class T, class Key, class Compare, class KeyOf>
+    template<class DataType>
+    class BST<T, Key, Compare, KeyOf>::NodeIterator {
+        const BST* tree;
+        Node* current;
+
+        NodeIterator(const BST* tree, Node* current) : tree(tree),
+                                                       current(current) {}
+
+        friend class BST;
+        template<class> friend class NodeIterator;
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef DataType* pointer;
+        typedef DataType& reference;
+
+        /**creates a singular iterator, that may only be assigned to */
+        NodeIterator() : tree(NULL), current(NULL) {}
+
+        /**an Iterator converts to a ConstIterator */
+        NodeIterator(const NodeIterator<T>& iterator) :
+                tree(iterator.tree), current(iterator.current) {}
+
+        DataType& operator*() const {
+            assert(current != NULL);
+            return current->data;
+        }
+
+        DataType* operator->() const {
+            return &**this;
+        }
+
+        /**@return the key of the current node */
+        Key key() const {
+            assert(current != NULL);
+            return current->getKey();
+        }
+
+        /**advances to the next key, from the last one to the end */
+        NodeIterator& operator++() {
+            assert(current != NULL);
+            if (current->right_son) {
+                current = current->right_son;
+                while (current->left_son)
+                    current = current->left_son;
+                return *this;
+            }
+            Node* child = current;
+            current = current->parent;
+            while (current && current->right_son == child) {
+                child = current;
+                current = current->parent;
+            }
+            return *this;
+        }
+
+        NodeIterator operator++(int) {
+            NodeIterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        /**moves back to the previous key, from the end to the last one */
+        NodeIterator& operator--() {
+            if (current == NULL) {
+                current = tree->root;
+                while (current && current->right_son)
+                    current = current->right_son;
+                return *this;
+            }
+            if (current->left_son) {
+                current = current->left_son;
+                while (current->right_son)
+                    current = current->right_son;
+                return *this;
+            }
+            Node* child = current;
+            current = current->parent;
+            while (current && current->left_son == child) {
+                child = current;
+                current = current->parent;
+            }
+            return *this;
+        }
+
+        NodeIterator operator--(int) {
+            NodeIterator result = *this;
+            --*this;
+            return result;
+        }
+
+        bool operator==(const NodeIterator& iterator) const {
+            return tree == iterator.tree && current == iterator.current;
+        }
+
+        bool operator!=(const NodeIterator& iterator) const {
+            return !(*this == iterator);
+        }
+    };
+
 /*-------------------------------------------------------------*/
 /*----------------------------NODE-----------------------------*/
-    template<class T, class Key>
-    BST<T, Key>::Node::Node(const T& data, const Key& key, int value):
-            data(data), key(key), size_of_sub_tree(1), weight(value), value(value),
-            parent(NULL), left_son(NULL), right_son(NULL) {}
+    template<class T, class Key, class Compare, class KeyOf>
+    BST<T, Key, Compare, KeyOf>::Node::Node(const T& data, const Key& key, int value):
+            KeyOf(data, key), data(data), size_of_sub_tree(1), value(value),
+            weight(value), parent(NULL), left_son(NULL), right_son(NULL) {
+        assert(Compare()(getKey(), key) == 0);
+    }
 
 /*-------------------------------------------------------------*/
 
@@ -0,0 +1,334 @@
+#include "BatchDriver.h"
+#include <cassert>
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <new>
+#include <unistd.h>
+
+static const char BATCH_MAGIC[8] = "DSWOPS";
+
+/**---------------------------PARSER HELPERS-------------------------------*/
+namespace {
+
+    bool isBlank(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    const char* skipBlanks(const char* p, const char* end) {
+        while (p != end && isBlank(*p))
+            p++;
+        return p;
+    }
+
+    /**@return true for an operation that answers with a number */
+    bool isQuery(char letter) {
+        return letter == 'T' || letter == 'S' || letter == 'K' ||
+               letter == 'W' || letter == 'F';
+    }
+
+    bool isDigit(char c) {
+        return (unsigned) (c - '0') <= 9;
+    }
+
+    /**parses an optionally negative decimal int at *cursor and moves the
+     * cursor past it
+     * @return false if there is no number there, or it doesn't fit an int */
+    bool parseInt(const char** cursor, const char* end, int* result) {
+        const char* p = *cursor;
+        bool negative = false;
+        if (p != end && *p == '-') {
+            negative = true;
+            p++;
+        }
+        if (p == end || !isDigit(*p))
+            return false;
+        long long limit = (long long) INT_MAX + (negative ? 1 : 0);
+        long long value = 0;
+        while (p != end && isDigit(*p)) {
+            value = value * 10 + (*p - '0');
+            if (value > limit)
+                return false;
+            p++;
+        }
+        *result = (int) (negative ? -value : value);
+        *cursor = p;
+        return true;
+    }
+}
+
+BatchDriver::BatchDriver(Colosseum& colosseum, int output) :
+        colosseum(colosseum), output(output), used(0), num_of_fights(0) {
+    Statistics empty = {0, 0, 0, 0, 0};
+    statistics = empty;
+}
+
+int BatchDriver::arity(char letter) {
+    switch (letter) {
+        case 'W':
+            return 0;
+        case 'G':
+        case 'X':
+        case 'R':
+        case 'T':
+        case 'S':
+        case 'K':
+            return 1;
+        case 'M':
+        case 'U':
+            return 2;
+        case 'A':
+        case 'F':
+            return 3;
+        default:
+            return -1;
+    }
+}
+
+bool BatchDriver::parseLine(const char* begin, const char* end,
+                            long long line, Operation* operation) {
+    const char* p = skipBlanks(begin, end);
+    if (p == end || *p == '#')
+        return false;
+    operation->letter = *p++;
+    int n = arity(operation->letter);
+    if (n < 0 || (p != end && !isBlank(*p)))
+        throw InvalidFormat(line);
+    for (int i = 0; i < n; i++) {
+        p = skipBlanks(p, end);
+        if (!parseInt(&p, end, &operation->arguments[i]) ||
+            (p != end && !isBlank(*p)))
+            throw InvalidFormat(line);
+    }
+    if (skipBlanks(p, end) != end)
+        throw InvalidFormat(line);
+    return true;
+}
+
+void BatchDriver::run(const char* data, size_t length) {
+    if (length >= sizeof(BATCH_MAGIC) &&
+        memcmp(data, BATCH_MAGIC, sizeof(BATCH_MAGIC)) == 0)
+        runBinary(data, length);
+    else
+        runText(data, length);
+}
+
+void BatchDriver::runText(const char* data, size_t length) {
+    const char* end = data + length;
+    long long line = 0;
+    while (data != end) {
+        const char* newline = (const char*) memchr(data, '\n', end - data);
+        const char* line_end = newline ? newline : end;
+        line++;
+        Operation operation;
+        bool parsed;
+        try {
+            parsed = parseLine(data, line_end, line, &operation);
+        } catch (InvalidFormat&) {
+            runFights();
+            throw;
+        }
+        if (parsed)
+            execute(operation);
+        data = newline ? newline + 1 : end;
+    }
+    runFights();
+    statistics.bytes_read += length;
+}
+
+void BatchDriver::runBinary(const char* data, size_t length) {
+    BinaryHeader header;
+    if (length < sizeof(header))
+        throw InvalidFormat(0);
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, BATCH_MAGIC, sizeof(BATCH_MAGIC)) != 0 ||
+        header.version != BINARY_VERSION ||
+        header.byte_order != BYTE_ORDER_MARK)
+        throw InvalidFormat(0);
+    const char* p = data + sizeof(header);
+    const char* end = data + length;
+    long long position = 0;
+    while (p != end) {
+        position++;
+        //the records aren't necessarily aligned, memcpy is a plain load
+        BinaryRecord record;
+        bool valid = (size_t) (end - p) >= sizeof(record);
+        if (valid) {
+            memcpy(&record, p, sizeof(record));
+            valid = record.operation == (char) record.operation &&
+                    arity((char) record.operation) >= 0;
+        }
+        if (!valid) {
+            runFights();
+            throw InvalidFormat(position);
+        }
+        Operation operation;
+        operation.letter = (char) record.operation;
+        for (int i = 0; i < 3; i++)
+            operation.arguments[i] = record.arguments[i];
+        execute(operation);
+        p += sizeof(record);
+    }
+    runFights();
+    statistics.bytes_read += length;
+}
+
+void BatchDriver::execute(const Operation& operation) {
+    const int* arguments = operation.arguments;
+    statistics.operations++;
+    if (operation.letter == 'F') {
+        Colosseum::Fight fight = {arguments[0], arguments[1], arguments[2],
+                                  0};
+        fights[num_of_fights++] = fight;
+        statistics.queries++;
+        if (num_of_fights == BATCH_MAX_FIGHT_RUN)
+            runFights();
+        return;
+    }
+    //keeps the results in order
+    runFights();
+    const char* status = NULL; //an error
+    bool is_query = isQuery(operation.letter);
+    long long result = 0;
+    try {
+        switch (operation.letter) {
+            case 'G':
+                colosseum.addGroup(arguments[0]);
+                break;
+            case 'X':
+                colosseum.removeGroup(arguments[0]);
+                break;
+            case 'M':
+                colosseum.absorb(arguments[0], arguments[1]);
+                break;
+            case 'A':
+                colosseum.addGladiator(arguments[0], arguments[1],
+                                       arguments[2]);
+                break;
+            case 'R':
+                colosseum.removeGladiator(arguments[0]);
+                break;
+            case 'U':
+                colosseum.updateScore(arguments[0], arguments[1]);
+                break;
+            case 'T':
+                result = colosseum.topKWeight(arguments[0]);
+                break;
+            case 'S':
+                result = colosseum.select(arguments[0]);
+                break;
+            case 'K':
+                result = colosseum.rank(arguments[0]);
+                break;
+            case 'W':
+                result = colosseum.getWeakestGroup();
+                break;
+            default:
+                assert(false);
+        }
+    } catch (Colosseum::InvalidInput&) {
+        status = "INVALID_INPUT";
+    } catch (Colosseum::ColosseumException&) {
+        status = "FAILURE";
+    } catch (std::bad_alloc&) {
+        status = "ALLOCATION_ERROR";
+    }
+    if (is_query)
+        statistics.queries++;
+    if (status)
+        writeStatus(status);
+    else if (is_query)
+        writeNumber(result);
+    else
+        writeStatus("SUCCESS");
+}
+
+void BatchDriver::runFights() {
+    int n = num_of_fights;
+    if (n == 0)
+        return;
+    num_of_fights = 0;
+    bool together = true;
+    try {
+        colosseum.fightMany(fights, n);
+    } catch (Colosseum::ColosseumException&) {
+        together = false;
+    } catch (std::bad_alloc&) {
+        together = false;
+    }
+    if (together) {
+        for (int i = 0; i < n; i++)
+            writeNumber(fights[i].winner);
+        return;
+    }
+    //fightMany ran none of them, one at a time each gets its own status
+    for (int i = 0; i < n; i++) {
+        const char* status = NULL;
+        int winner = 0;
+        try {
+            winner = colosseum.fight(fights[i].group_a, fights[i].group_b,
+                                     fights[i].k);
+        } catch (Colosseum::InvalidInput&) {
+            status = "INVALID_INPUT";
+        } catch (Colosseum::ColosseumException&) {
+            status = "FAILURE";
+        } catch (std::bad_alloc&) {
+            status = "ALLOCATION_ERROR";
+        }
+        if (status)
+            writeStatus(status);
+        else
+            writeNumber(winner);
+    }
+}
+
+void BatchDriver::writeStatus(const char* status) {
+    if (strcmp(status, "SUCCESS") != 0)
+        statistics.failed++;
+    append(status, strlen(status));
+    append("\n", 1);
+}
+
+void BatchDriver::writeNumber(long long number) {
+    char digits[24];
+    char* p = digits + sizeof(digits);
+    *--p = '\n';
+    unsigned long long magnitude = number < 0 ?
+                                   0ULL - (unsigned long long) number :
+                                   (unsigned long long) number;
+    do {
+        *--p = (char) ('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (number < 0)
+        *--p = '-';
+    append(p, digits + sizeof(digits) - p);
+}
+
+void BatchDriver::append(const char* source, size_t size) {
+    if (used + size > BATCH_OUTPUT_BUFFER_SIZE)
+        flush();
+    memcpy(buffer + used, source, size);
+    used += size;
+}
+
+void BatchDriver::flush() {
+    size_t written = 0;
+    while (written < used) {
+        ssize_t result = write(output, buffer + written, used - written);
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result <= 0) {
+            //drop what's left, a retry would write it twice
+            used = 0;
+            throw IOError();
+        }
+        written += result;
+    }
+    statistics.bytes_written += used;
+    used = 0;
+}
+
+const BatchDriver::Statistics& BatchDriver::getStatistics() const {
+    return statistics;
+}
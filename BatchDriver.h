@@ -0,0 +1,148 @@
+#ifndef DSWET2_BATCHDRIVER_H
+#define DSWET2_BATCHDRIVER_H
+
+#include "Colosseum.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <exception>
+
+/**output buffer size of the batch driver */
+#define BATCH_OUTPUT_BUFFER_SIZE (1 << 16)
+
+/**largest number of consecutive fights run as one fightMany */
+#define BATCH_MAX_FIGHT_RUN 4096
+
+/**---------------------------BATCH DRIVER-------------------------------
+ * Runs a stream of operations against a Colosseum and writes one line per
+ * operation to a file descriptor. The operations are parsed in place from
+ * a range of memory (a mapped file, see main.cpp), nothing is copied.
+ * Operations, the letter and its arguments:
+ *      G group                     addGroup
+ *      X group                     removeGroup
+ *      M group absorbed            absorb
+ *      A gladiator score group     addGladiator
+ *      R gladiator                 removeGladiator
+ *      U gladiator score           updateScore
+ *      F group_a group_b k         fight           -> the winner
+ *      T k                         topKWeight      -> the sum
+ *      S k                         select          -> the gladiator
+ *      K gladiator                 rank            -> the position
+ *      W                           getWeakestGroup -> the group
+ * Text encoding: an operation per line, the letter and the arguments as
+ * decimal integers, separated by spaces or tabs. Empty lines and lines
+ * starting with '#' are skipped.
+ * Binary encoding: a BinaryHeader, then a BinaryRecord per operation, in
+ * native byte order. Checked through BinaryHeader::byte_order.
+ * Output, in both encodings: the result of a query, SUCCESS for a change,
+ * or INVALID_INPUT, FAILURE or ALLOCATION_ERROR for an operation that
+ * failed, which doesn't stop the run.
+ * Consecutive fights are run as one Colosseum::fightMany. */
+class BatchDriver {
+public:
+    static const uint32_t BINARY_VERSION = 1;
+    static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    struct BinaryHeader {
+        char magic[8];                  //"DSWOPS"
+        uint32_t version;
+        uint32_t byte_order;
+    };
+
+    struct BinaryRecord {
+        int32_t operation;              //the letter of the operation
+        int32_t arguments[3];           //unused ones are ignored
+    };
+
+    struct Statistics {
+        long long operations;
+        long long queries;
+        long long failed;               //answered with an error status
+        long long bytes_read;
+        long long bytes_written;
+    };
+
+private:
+    /**a parsed operation */
+    struct Operation {
+        char letter;
+        int arguments[3];
+    };
+
+    Colosseum& colosseum;
+    int output;
+    char buffer[BATCH_OUTPUT_BUFFER_SIZE];
+    size_t used;
+    Statistics statistics;
+    Colosseum::Fight fights[BATCH_MAX_FIGHT_RUN];
+    int num_of_fights; //the pending run of fights
+
+    BatchDriver(const BatchDriver&);
+    BatchDriver& operator=(const BatchDriver&);
+
+    /**@return the number of arguments of the operation, or -1 for a letter
+     *         that isn't an operation */
+    static int arity(char letter);
+
+    /**parses the text line [begin, end)
+     * @return false for a line with no operation
+     * @exception InvalidFormat - a malformed line, position is line */
+    static bool parseLine(const char* begin, const char* end,
+                          long long line, Operation* operation);
+
+    /**runs the operation, or holds it back if it is a fight */
+    void execute(const Operation& operation);
+
+    /**runs the pending fights and writes their winners */
+    void runFights();
+
+    void writeStatus(const char* status);
+    void writeNumber(long long number);
+    void append(const char* source, size_t size);
+
+public:
+    /**CONSTRUCTOR
+     * @param colosseum - the operations run against it. Not owned
+     * @param output - the results are written to it. Not owned, not closed */
+    BatchDriver(Colosseum& colosseum, int output);
+
+    /**RUN
+     * runs every operation of data, in the encoding its start tells
+     * (binary if it starts with the magic, text otherwise). The results may
+     * stay in the buffer until flush
+     * @exception InvalidFormat - a malformed operation. The operations
+     *                            before it have run
+     * @exception IOError - the output couldn't be written */
+    void run(const char* data, size_t length);
+
+    /**RUN TEXT / RUN BINARY
+     * as run, in the given encoding. runBinary expects the header */
+    void runText(const char* data, size_t length);
+    void runBinary(const char* data, size_t length);
+
+    /**FLUSH
+     * writes the buffered results
+     * @exception IOError - the output couldn't be written */
+    void flush();
+
+    const Statistics& getStatistics() const;
+
+    class BatchException : public std::exception {
+    };
+
+    class InvalidFormat : public BatchException {
+        long long position;
+    public:
+        explicit InvalidFormat(long long position) : position(position) {}
+
+        /**@return the line of a text input, the record of a binary one,
+         *         both counted from 1, or 0 for a bad binary header */
+        long long getPosition() const {
+            return position;
+        }
+    };
+
+    class IOError : public BatchException {
+    };
+};
+
+#endif //DSWET2_BATCHDRIVER_H
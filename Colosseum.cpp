@@ -0,0 +1,309 @@
+
+#include "Colosseum.h"
+#include <algorithm>
+#include <functional>
+#if __cplusplus >= 201103L
+#include <thread>
+#include <vector>
+#endif
+
+/**a top-k sum one side of a fight needs */
+struct TopKQuery {
+    Group* group;
+    int k;
+    int fight; //index of the fight, times 2, plus 1 for group_b
+    long long sum;
+};
+
+/**orders the queries by group, then by k */
+class CompareQueries {
+public:
+    bool operator()(const TopKQuery& a, const TopKQuery& b) const {
+        if (a.group != b.group)
+            return std::less<Group*>()(a.group, b.group);
+        return a.k < b.k;
+    }
+};
+
+/**computes the sums of queries[begin, end), reusing the sum of the query
+ * before for a repeated (group, k) */
+static void runQueries(TopKQuery* queries, int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        if (i > begin && queries[i].group == queries[i - 1].group &&
+            queries[i].k == queries[i - 1].k)
+            queries[i].sum = queries[i - 1].sum;
+        else
+            queries[i].sum = queries[i].group->sumOfTopK(queries[i].k);
+    }
+}
+
+/**takes each gladiator it is applied on out of the indexes */
+class Unindex {
+    GladiatorIndex& index;
+    Leaderboard& leaderboard;
+public:
+    Unindex(GladiatorIndex& index, Leaderboard& leaderboard) :
+            index(index), leaderboard(leaderboard) {}
+
+    void operator()(const Gladiator& gladiator) {
+        index.remove(gladiator.getId());
+        leaderboard.remove(gladiator.getId(), gladiator.getScore());
+    }
+};
+
+Colosseum::Colosseum() {}
+
+Group& Colosseum::fighter(int group_id, int k) {
+    Group& group = getGroup(group_id);
+    if (k < 1 || group.getNumOfGladiators() < k)
+        throw InvalidInput();
+    return group;
+}
+
+int Colosseum::winner(const Group& a, long long sum_a, const Group& b,
+                      long long sum_b) {
+    if (sum_a != sum_b)
+        return sum_a > sum_b ? a.getID() : b.getID();
+    return a.getID() < b.getID() ? a.getID() : b.getID();
+}
+
+Group& Colosseum::groupOf(int gladiator_id) {
+    try {
+        return groups.find(index.find(gladiator_id).group_id);
+    } catch (GladiatorIndex::KeyNotFound&) {
+        throw KeyNotFound();
+    }
+}
+
+void Colosseum::addGroup(int group_id) {
+    if (group_id < 0)
+        throw InvalidInput();
+    try {
+        groups.insert(Group(group_id));
+    } catch (HashTable::KeyAlreadyExist&) {
+        throw KeyAlreadyExist();
+    }
+    groups.find(group_id).setObserver(this);
+    try {
+        weakest.insert(group_id, 0);
+        lowest.insert(group_id, group_id);
+    } catch (...) {
+        if (weakest.contains(group_id))
+            weakest.remove(group_id);
+        groups.remove(group_id);
+        throw;
+    }
+}
+
+void Colosseum::removeGroup(int group_id) {
+    const Group& group = getGroup(group_id);
+    int id = group.getID();
+    Unindex unindex(index, leaderboard);
+    group.forEachGladiator(unindex);
+    groups.remove(group_id);
+    weakest.remove(id);
+    lowest.remove(id);
+}
+
+void Colosseum::absorb(int group_id, int absorbed_id) {
+    int live = getGroup(group_id).getID();
+    int dead = getGroup(absorbed_id).getID();
+    if (live == dead)
+        return;
+    long long absorbed_total = weakest.getKey(dead);
+    groups.absorb(live, dead);
+    weakest.remove(dead);
+    lowest.remove(dead);
+    weakest.increaseKey(live, weakest.getKey(live) + absorbed_total);
+}
+
+void Colosseum::addGladiator(int gladiator_id, int score, int group_id) {
+    if (gladiator_id < 0 || score < 0 || group_id < 0)
+        throw InvalidInput();
+    if (index.contains(gladiator_id))
+        throw KeyAlreadyExist();
+    getGroup(group_id).addGladiator(gladiator_id, score);
+}
+
+void Colosseum::removeGladiator(int gladiator_id) {
+    groupOf(gladiator_id).removeGladiator(gladiator_id);
+}
+
+void Colosseum::updateScore(int gladiator_id, int score) {
+    if (score < 0)
+        throw InvalidInput();
+    groupOf(gladiator_id).updateScore(gladiator_id, score);
+}
+
+int Colosseum::getGroupOf(int gladiator_id) const {
+    try {
+        return groups.find(index.find(gladiator_id).group_id).getID();
+    } catch (GladiatorIndex::KeyNotFound&) {
+        throw KeyNotFound();
+    }
+}
+
+int Colosseum::getScore(int gladiator_id) const {
+    try {
+        return index.find(gladiator_id).score;
+    } catch (GladiatorIndex::KeyNotFound&) {
+        throw KeyNotFound();
+    }
+}
+
+Group& Colosseum::getGroup(int group_id) {
+    try {
+        return groups.find(group_id);
+    } catch (HashTable::KeyNotFound&) {
+        throw KeyNotFound();
+    }
+}
+
+int Colosseum::select(int k) {
+    try {
+        return leaderboard.select(k);
+    } catch (Leaderboard::InvalidInput&) {
+        throw InvalidInput();
+    }
+}
+
+int Colosseum::rank(int gladiator_id) {
+    return leaderboard.rank(gladiator_id, getScore(gladiator_id));
+}
+
+long long Colosseum::topKWeight(int k) {
+    try {
+        return leaderboard.topKWeight(k);
+    } catch (Leaderboard::InvalidInput&) {
+        throw InvalidInput();
+    }
+}
+
+int Colosseum::fight(int group_a, int group_b, int k) {
+    Group& a = fighter(group_a, k);
+    Group& b = fighter(group_b, k);
+    if (&a == &b)
+        throw InvalidInput();
+    return winner(a, a.sumOfTopK(k), b, b.sumOfTopK(k));
+}
+
+void Colosseum::fightMany(Fight* fights, int n, int num_threads) {
+    if (n <= 0)
+        return;
+    //resolve and check everything first. Resolving may compress the
+    //group table's paths, so it isn't done by the threads
+    TopKQuery* queries = new TopKQuery[2 * n];
+    long long* sums = NULL;
+    try {
+        for (int i = 0; i < n; i++) {
+            Group& a = fighter(fights[i].group_a, fights[i].k);
+            Group& b = fighter(fights[i].group_b, fights[i].k);
+            if (&a == &b)
+                throw InvalidInput();
+            TopKQuery query_a = {&a, fights[i].k, 2 * i, 0};
+            TopKQuery query_b = {&b, fights[i].k, 2 * i + 1, 0};
+            queries[2 * i] = query_a;
+            queries[2 * i + 1] = query_b;
+        }
+        sums = new long long[2 * n];
+    } catch (...) {
+        delete[] queries;
+        throw;
+    }
+    std::sort(queries, queries + 2 * n, CompareQueries());
+
+    if (num_threads > 2 * n / COLOSSEUM_PARALLEL_MIN_QUERIES)
+        num_threads = 2 * n / COLOSSEUM_PARALLEL_MIN_QUERIES;
+#if __cplusplus >= 201103L
+    if (num_threads > 1) {
+        //thread t runs [bounds[t], bounds[t + 1]), each bound moved forward
+        //to the start of a group, so no tree is splayed by two threads
+        std::vector<int> bounds(num_threads + 1, 2 * n);
+        bounds[0] = 0;
+        for (int t = 1; t < num_threads; t++) {
+            int bound = (int) ((long long) t * 2 * n / num_threads);
+            if (bound < bounds[t - 1])
+                bound = bounds[t - 1];
+            while (bound > 0 && bound < 2 * n &&
+                   queries[bound].group == queries[bound - 1].group)
+                bound++;
+            bounds[t] = bound;
+        }
+        std::vector<std::thread> workers;
+        for (int t = 0; t < num_threads; t++)
+            workers.push_back(std::thread(runQueries, queries, bounds[t],
+                                          bounds[t + 1]));
+        for (int t = 0; t < num_threads; t++)
+            workers[t].join();
+    } else
+#endif
+    {
+        runQueries(queries, 0, 2 * n);
+    }
+
+    for (int i = 0; i < 2 * n; i++)
+        sums[queries[i].fight] = queries[i].sum;
+    for (int i = 0; i < n; i++) {
+        //the groups were checked above, both finds succeed
+        fights[i].winner = winner(getGroup(fights[i].group_a), sums[2 * i],
+                                  getGroup(fights[i].group_b),
+                                  sums[2 * i + 1]);
+    }
+    delete[] queries;
+    delete[] sums;
+}
+
+int Colosseum::getWeakestGroup() const {
+    try {
+        return weakest.getMin();
+    } catch (GroupHeap::Empty&) {
+        throw KeyNotFound();
+    }
+}
+
+int Colosseum::getLowestGroup() const {
+    try {
+        return lowest.getMin();
+    } catch (GroupHeap::Empty&) {
+        throw KeyNotFound();
+    }
+}
+
+long long Colosseum::getTotalScore(int group_id) {
+    return weakest.getKey(getGroup(group_id).getID());
+}
+
+int Colosseum::getNumOfGroups() const {
+    return groups.getSize();
+}
+
+int Colosseum::getNumOfGladiators() const {
+    return index.getSize();
+}
+
+void Colosseum::gladiatorAdded(const Group& group, int gladiator_id,
+                               int score) {
+    index.insert(gladiator_id, group.getID(), score);
+    try {
+        leaderboard.add(gladiator_id, score);
+    } catch (...) {
+        index.remove(gladiator_id);
+        throw;
+    }
+    weakest.increaseKey(group.getID(), weakest.getKey(group.getID()) + score);
+}
+
+void Colosseum::gladiatorRemoved(const Group& group, int gladiator_id,
+                                 int score) {
+    index.remove(gladiator_id);
+    leaderboard.remove(gladiator_id, score);
+    weakest.decreaseKey(group.getID(), weakest.getKey(group.getID()) - score);
+}
+
+void Colosseum::scoreUpdated(const Group& group, int gladiator_id,
+                             int old_score, int new_score) {
+    leaderboard.update(gladiator_id, old_score, new_score);
+    index.setScore(gladiator_id, new_score);
+    weakest.setKey(group.getID(),
+                   weakest.getKey(group.getID()) - old_score + new_score);
+}
@@ -0,0 +1,193 @@
+
+#ifndef DSWET2_COLOSSEUM_H
+#define DSWET2_COLOSSEUM_H
+
+#include "HashTable.h"
+#include "GladiatorIndex.h"
+#include "Leaderboard.h"
+#include "GroupHeap.h"
+#include "GroupObserver.h"
+#include <exception>
+
+/**minimal number of top-k queries per thread in fightMany */
+#define COLOSSEUM_PARALLEL_MIN_QUERIES 1024
+
+/**---------------------------COLOSSEUM----------------------------------
+ * The whole system: the groups (a HashTable) and the indexes kept over all
+ * of their gladiators. Every group in the colosseum has the colosseum as
+ * its observer, so a change made through a group (see getGroup) updates the
+ * indexes as well as a change made through the colosseum.
+ * Gladiator ids are unique across all the groups.
+ * The indexes:
+ *  - GladiatorIndex - gladiator id -> (group, score). A gladiator is
+ *    located in O(1), so updating or removing it costs O(1) plus the
+ *    O(log n) of its group's trees, instead of a search of every group.
+ *  - Leaderboard - every gladiator by (score desc, id asc), for the global
+ *    position and top-k queries in amortized O(log N), without asking
+ *    each group and merging.
+ *  - GroupHeap - the groups by the sum of their scores, and by id, for the
+ *    weakest and the lowest group in O(1) with O(log G) updates, instead
+ *    of a scan of the group table. */
+class Colosseum : public GroupObserver {
+    HashTable groups;
+    GladiatorIndex index;
+    Leaderboard leaderboard;
+    GroupHeap weakest; //key - the sum of the group's scores
+    GroupHeap lowest; //key - the group's id
+
+    Colosseum(const Colosseum&);
+    Colosseum& operator=(const Colosseum&);
+
+    /**@return the group a fight of k gladiators draws from
+     * @exception KeyNotFound - there is no such group
+     * @exception InvalidInput - k < 1, or the group has less than k */
+    Group& fighter(int group_id, int k);
+
+    /**@return the winner of two groups whose top-k sums are sum_a, sum_b */
+    static int winner(const Group& a, long long sum_a, const Group& b,
+                      long long sum_b);
+
+    /**@return the group the gladiator is in
+     * @exception KeyNotFound - the gladiator isn't in any group */
+    Group& groupOf(int gladiator_id);
+
+public:
+    /**a fight of fightMany. group_a, group_b and k are the arguments of
+     * fight, winner is set to its result */
+    struct Fight {
+        int group_a;
+        int group_b;
+        int k;
+        int winner;
+    };
+
+    Colosseum();
+
+    /**ADD GROUP
+     * @exception InvalidInput - a negative id
+     * @exception KeyAlreadyExist - group_id is taken, by a group or by an
+     *                              absorbed group */
+    void addGroup(int group_id);
+
+    /**REMOVE GROUP
+     * removes the group group_id resolves to, with its gladiators
+     * @exception KeyNotFound - there is no such group */
+    void removeGroup(int group_id);
+
+    /**ABSORB
+     * moves the gladiators of absorbed_id's group into group_id's group and
+     * removes the emptied group, see HashTable::absorb
+     * @exception KeyNotFound - there is no such group */
+    void absorb(int group_id, int absorbed_id);
+
+    /**ADD GLADIATOR
+     * @exception InvalidInput - a negative id or score
+     * @exception KeyAlreadyExist - the gladiator is already in a group
+     * @exception KeyNotFound - there is no such group */
+    void addGladiator(int gladiator_id, int score, int group_id);
+
+    /**REMOVE GLADIATOR
+     * @exception KeyNotFound - the gladiator isn't in any group */
+    void removeGladiator(int gladiator_id);
+
+    /**UPDATE SCORE
+     * @exception InvalidInput - a negative score
+     * @exception KeyNotFound - the gladiator isn't in any group */
+    void updateScore(int gladiator_id, int score);
+
+    /**GET GROUP OF
+     * @return the id of the group the gladiator is in, in O(1)
+     * @exception KeyNotFound - the gladiator isn't in any group */
+    int getGroupOf(int gladiator_id) const;
+
+    /**GET SCORE
+     * @return the gladiator's score, in O(1)
+     * @exception KeyNotFound - the gladiator isn't in any group */
+    int getScore(int gladiator_id) const;
+
+    /**GET GROUP
+     * @return the group group_id resolves to. Adding, removing and updating
+     *         its gladiators is seen by the colosseum. Absorb groups and
+     *         load gladiators through the colosseum only
+     * @exception KeyNotFound - there is no such group */
+    Group& getGroup(int group_id);
+
+    /**SELECT
+     * @return the id of the gladiator at position k of the whole
+     *         colosseum, 1 is the best (see Leaderboard)
+     * @exception InvalidInput - k isn't in [1, number of gladiators] */
+    int select(int k);
+
+    /**RANK
+     * @return the position of the gladiator in the whole colosseum
+     * @exception KeyNotFound - the gladiator isn't in any group */
+    int rank(int gladiator_id);
+
+    /**TOP K WEIGHT
+     * @return the sum of the k best scores of the whole colosseum
+     * @exception InvalidInput - k isn't in [0, number of gladiators] */
+    long long topKWeight(int k);
+
+    /**FIGHT
+     * the group whose k best gladiators have the higher score sum wins, on
+     * a tie the group with the lower id. Each sum is a single descent of
+     * the group's score tree (Group::sumOfTopK), O(log n) amortized. Only
+     * the trees' shapes change
+     * @return the id of the winning group
+     * @exception KeyNotFound - there is no such group
+     * @exception InvalidInput - group_a and group_b are the same group,
+     *                           k < 1, or a group has less than k */
+    int fight(int group_a, int group_b, int k);
+
+    /**FIGHT MANY
+     * runs n fights and sets their winners. The top-k queries are sorted
+     * by group, so the fights of a group run one after another while its
+     * tree is hot, and a (group, k) that repeats is computed once.
+     * All the fights are checked before any is run, so on an exception no
+     * winner is set
+     * @param num_threads - when larger than 1 (C++11 builds only), the
+     *                      sorted queries are split between threads on
+     *                      group boundaries, so every group is used by one
+     *                      thread. Threads are started per call
+     * @exception as fight */
+    void fightMany(Fight* fights, int n, int num_threads = 1);
+
+    /**GET WEAKEST GROUP
+     * @return the id of the group with the lowest sum of scores, the lower
+     *         id on a tie, in O(1)
+     * @exception KeyNotFound - there are no groups */
+    int getWeakestGroup() const;
+
+    /**GET LOWEST GROUP
+     * @return the lowest id of a group, in O(1)
+     * @exception KeyNotFound - there are no groups */
+    int getLowestGroup() const;
+
+    /**GET TOTAL SCORE
+     * @return the sum of the scores of the group group_id resolves to
+     * @exception KeyNotFound - there is no such group */
+    long long getTotalScore(int group_id);
+
+    int getNumOfGroups() const;
+    int getNumOfGladiators() const;
+
+    /**--------------------------GROUP OBSERVER-------------------------*/
+    void gladiatorAdded(const Group& group, int gladiator_id, int score);
+    void gladiatorRemoved(const Group& group, int gladiator_id, int score);
+    void scoreUpdated(const Group& group, int gladiator_id, int old_score,
+                      int new_score);
+
+    class ColosseumException : public std::exception {
+    };
+
+    class InvalidInput : public ColosseumException {
+    };
+
+    class KeyNotFound : public ColosseumException {
+    };
+
+    class KeyAlreadyExist : public ColosseumException {
+    };
+};
+
+#endif //DSWET2_COLOSSEUM_H
@@ -0,0 +1,168 @@
+#ifndef DSWET2_CONCURRENTHASHTABLE_H
+#define DSWET2_CONCURRENTHASHTABLE_H
+
+#if __cplusplus < 201103L
+#error "ConcurrentHashTable requires C++11 or later"
+#endif
+
+#include "HashTable.h"
+#include <pthread.h>
+#include <atomic>
+
+/**number of independently locked stripes (must be a power of 2) */
+#define CONCURRENT_HASH_TABLE_STRIPES 64
+
+/**---------------------------CONCURRENT HASH TABLE--------------------------
+ * A group table that can be shared by many worker threads.
+ * The groups are split between CONCURRENT_HASH_TABLE_STRIPES stripes by a
+ * multiplicative hash of the group id. Each stripe is a regular HashTable
+ * guarded by its own readers-writer lock, so:
+ *  - lookups only take a shared lock on one stripe and run in parallel with
+ *    every other lookup, and with writers of other stripes.
+ *  - insert/remove take an exclusive lock on one stripe only.
+ *  - a stripe resizes under its own exclusive lock, the rest of the table
+ *    stays available during the resize.
+ * Groups are never handed out by reference, since a reference could outlive
+ * the lock that protects it. Instead the caller passes a function object
+ * that is applied to the group while the stripe is locked.
+ * find/insert/remove throw the same exceptions as HashTable. */
+class ConcurrentHashTable {
+
+    struct alignas(64) Stripe {
+        mutable pthread_rwlock_t lock;
+        HashTable table;
+
+        Stripe() {
+            pthread_rwlock_init(&lock, NULL);
+        }
+
+        ~Stripe() {
+            pthread_rwlock_destroy(&lock);
+        }
+    };
+
+    /**locks a stripe for reading for the lifetime of the object */
+    class ReadLock {
+        pthread_rwlock_t* lock;
+    public:
+        explicit ReadLock(pthread_rwlock_t* lock) : lock(lock) {
+            pthread_rwlock_rdlock(lock);
+        }
+
+        ~ReadLock() {
+            pthread_rwlock_unlock(lock);
+        }
+    };
+
+    /**locks a stripe for writing for the lifetime of the object */
+    class WriteLock {
+        pthread_rwlock_t* lock;
+    public:
+        explicit WriteLock(pthread_rwlock_t* lock) : lock(lock) {
+            pthread_rwlock_wrlock(lock);
+        }
+
+        ~WriteLock() {
+            pthread_rwlock_unlock(lock);
+        }
+    };
+
+    Stripe stripes[CONCURRENT_HASH_TABLE_STRIPES];
+    std::atomic<int> num_of_items;
+
+    /**the stripe is taken from the high bits of a multiplicative hash (not
+     * swiss::mix), so it doesn't correlate with the probe group (h1) or the
+     * tag (h2) the stripe's table derives from the same id */
+    Stripe& stripeOf(int group_id) {
+        unsigned int mixed = (unsigned int) group_id * 2654435761u;
+        return stripes[mixed >> (32 - stripeBits())];
+    }
+
+    const Stripe& stripeOf(int group_id) const {
+        return const_cast<ConcurrentHashTable*>(this)->stripeOf(group_id);
+    }
+
+    static int stripeBits() {
+        int bits = 0;
+        while ((1 << bits) < CONCURRENT_HASH_TABLE_STRIPES)
+            bits++;
+        return bits;
+    }
+
+public:
+    ConcurrentHashTable();
+
+    ConcurrentHashTable(const ConcurrentHashTable&) = delete;
+    ConcurrentHashTable& operator=(const ConcurrentHashTable&) = delete;
+
+    /**INSERT
+     * @param group - copied into the table
+     * @exception HashTable::KeyAlreadyExist */
+    void insert(const Group& group);
+
+    /**REMOVE
+     * @exception HashTable::KeyNotFound */
+    void remove(int group_id);
+
+    /**CONTAINS
+     * @return true if a group with group_id is in the table */
+    bool contains(int group_id) const;
+
+    /**FIND
+     * applies function(const Group&) on the group while its stripe is locked
+     * for reading. Many find calls may run at the same time.
+     * @exception HashTable::KeyNotFound */
+    template<class Func>
+    void find(int group_id, Func& function) const;
+
+    /**MODIFY
+     * applies function(Group&) on the group while its stripe is locked for
+     * writing.
+     * @exception HashTable::KeyNotFound */
+    template<class Func>
+    void modify(int group_id, Func& function);
+
+    int getSize() const;
+};
+
+inline ConcurrentHashTable::ConcurrentHashTable() : num_of_items(0) {}
+
+inline void ConcurrentHashTable::insert(const Group& group) {
+    Stripe& stripe = stripeOf(group.getID());
+    WriteLock guard(&stripe.lock);
+    stripe.table.insert(group);
+    num_of_items++;
+}
+
+inline void ConcurrentHashTable::remove(int group_id) {
+    Stripe& stripe = stripeOf(group_id);
+    WriteLock guard(&stripe.lock);
+    stripe.table.remove(group_id);
+    num_of_items--;
+}
+
+inline bool ConcurrentHashTable::contains(int group_id) const {
+    const Stripe& stripe = stripeOf(group_id);
+    ReadLock guard(&stripe.lock);
+    return stripe.table.contains(group_id);
+}
+
+template<class Func>
+void ConcurrentHashTable::find(int group_id, Func& function) const {
+    const Stripe& stripe = stripeOf(group_id);
+    ReadLock guard(&stripe.lock);
+    function(stripe.table.find(group_id));
+}
+
+template<class Func>
+void ConcurrentHashTable::modify(int group_id, Func& function) {
+    Stripe& stripe = stripeOf(group_id);
+    WriteLock guard(&stripe.lock);
+    function(stripe.table.find(group_id));
+}
+
+inline int ConcurrentHashTable::getSize() const {
+    return num_of_items.load();
+}
+
+#endif //DSWET2_CONCURRENTHASHTABLE_H
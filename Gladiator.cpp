@@ -4,7 +4,9 @@
 
 #include "Gladiator.h"
 
-//TODO Gladiator::Gladiator() : id(INVALID_KEY), score(INVALID_KEY){}
+#define INVALID_KEY -1
+
+Gladiator::Gladiator() : id(INVALID_KEY), score(INVALID_KEY) {}
 
 Gladiator::Gladiator(int id, int score) :
         id(id), score(score) {}
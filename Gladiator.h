@@ -17,9 +17,9 @@ class Gladiator {
 
 public:
     /**EMPTY CONSTRUCTOR
-     * initialize a Gladiator with invalid keys and a null trainet
+     * initialize a Gladiator with invalid id and score
      */
-    //TODO Gladiator();
+    Gladiator();
 
     /**CONSTRUCTOR
      * initialize a gladiator with the following details:
@@ -0,0 +1,43 @@
+
+#include "GladiatorIndex.h"
+
+void GladiatorIndex::insert(int gladiator_id, int group_id, int score) {
+    Entry entry;
+    entry.group_id = group_id;
+    entry.score = score;
+    try {
+        entries.insert(gladiator_id, entry);
+    } catch (IntMap<Entry>::KeyAlreadyExist&) {
+        throw KeyAlreadyExist();
+    }
+}
+
+void GladiatorIndex::remove(int gladiator_id) {
+    try {
+        entries.remove(gladiator_id);
+    } catch (IntMap<Entry>::KeyNotFound&) {
+        throw KeyNotFound();
+    }
+}
+
+void GladiatorIndex::setScore(int gladiator_id, int score) {
+    Entry* entry = entries.find(gladiator_id);
+    if (entry == NULL)
+        throw KeyNotFound();
+    entry->score = score;
+}
+
+const GladiatorIndex::Entry& GladiatorIndex::find(int gladiator_id) const {
+    const Entry* entry = entries.find(gladiator_id);
+    if (entry == NULL)
+        throw KeyNotFound();
+    return *entry;
+}
+
+bool GladiatorIndex::contains(int gladiator_id) const {
+    return entries.find(gladiator_id) != NULL;
+}
+
+int GladiatorIndex::getSize() const {
+    return entries.getSize();
+}
@@ -0,0 +1,56 @@
+
+#ifndef DSWET2_GLADIATORINDEX_H
+#define DSWET2_GLADIATORINDEX_H
+
+#include "IntMap.h"
+#include <exception>
+
+/**---------------------------GLADIATOR INDEX----------------------------------
+ * Where each gladiator is: gladiator id -> (group id, score), flat in an
+ * IntMap, so locating a gladiator is one hash lookup whatever the number of
+ * groups. The group id is the one the gladiator was added to. Once that
+ * group is absorbed the id still resolves to the absorbing group through
+ * the HashTable's union-find, so an absorb doesn't touch the index. */
+class GladiatorIndex {
+public:
+    struct Entry {
+        int group_id;
+        int score;
+    };
+
+private:
+    IntMap<Entry> entries; //key - gladiator id
+
+public:
+    /**INSERT
+     * @exception KeyAlreadyExist - the gladiator is already indexed */
+    void insert(int gladiator_id, int group_id, int score);
+
+    /**REMOVE
+     * @exception KeyNotFound - the gladiator isn't indexed */
+    void remove(int gladiator_id);
+
+    /**SET SCORE
+     * @exception KeyNotFound - the gladiator isn't indexed */
+    void setScore(int gladiator_id, int score);
+
+    /**FIND
+     * @return the gladiator's entry, valid until the next insert or remove
+     * @exception KeyNotFound - the gladiator isn't indexed */
+    const Entry& find(int gladiator_id) const;
+
+    bool contains(int gladiator_id) const;
+
+    int getSize() const;
+
+    class GladiatorIndexException : public std::exception {
+    };
+
+    class KeyNotFound : public GladiatorIndexException {
+    };
+
+    class KeyAlreadyExist : public GladiatorIndexException {
+    };
+};
+
+#endif //DSWET2_GLADIATORINDEX_H
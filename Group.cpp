@@ -3,15 +3,723 @@
 //
 
 #include "Group.h"
+#include <algorithm>
+#include <cassert>
+#include <string.h>
 #define  INVALID_KEY -1 //TODO CHECK FOR DOUBLE DEFINE
-Group::Group():id(INVALID_KEY) {}
 
-Group::Group(int id) {
+/**orders gladiators like their ScoreKey */
+class CompareScores {
+public:
+    bool operator()(const Gladiator& first, const Gladiator& second) const {
+        return ScoreKey(first.getScore(), first.getId()) <
+               ScoreKey(second.getScore(), second.getId());
+    }
+};
+
+/**orders the inline indices of a group by the ids at them */
+class CompareIds {
+    const Gladiator* gladiators;
+public:
+    explicit CompareIds(const Gladiator* gladiators) :
+            gladiators(gladiators) {}
+
+    bool operator()(int first, int second) const {
+        return gladiators[first].getId() < gladiators[second].getId();
+    }
+};
+
+/**copies the ids and the scores of the gladiators it is applied on */
+class CopyColumns {
+    int* ids;
+    int* scores;
+    int size;
+public:
+    CopyColumns(int* ids, int* scores) : ids(ids), scores(scores), size(0) {}
+
+    void operator()(const Gladiator& gladiator) {
+        ids[size] = gladiator.getId();
+        scores[size] = gladiator.getScore();
+        size++;
+    }
+};
+
+/**@return a new array of capacity ints, starting with source[0..n) */
+static int* copyColumn(const int* source, int n, int capacity) {
+    int* column = new int[capacity];
+    for (int i = 0; i < n; i++)
+        column[i] = source[i];
+    return column;
+}
+
+Group::Group():id(INVALID_KEY), observer(NULL), is_small(true),
+               small_size(0), small_version(0), column_ids(NULL),
+               column_scores(NULL), column_size(0), column_capacity(0),
+               next_cached(0), cache_hits(0), cache_misses(0) {
+    small_prefix[0] = 0;
+    clearCache();
+}
+
+Group::Group(int id) : observer(NULL), is_small(true), small_size(0),
+                       small_version(0), column_ids(NULL),
+                       column_scores(NULL), column_size(0),
+                       column_capacity(0), next_cached(0), cache_hits(0),
+                       cache_misses(0) {
     if (id < 0)
         throw InvalidInput();
     this->id = id;
+    small_prefix[0] = 0;
+    clearCache();
+}
+
+Group::Group(const Group& group) : id(group.id), gladiators(group.gladiators),
+                                   by_score(group.by_score), observer(NULL),
+                                   is_small(group.is_small),
+                                   small_size(group.small_size),
+                                   small_version(0), column_ids(NULL),
+                                   column_scores(NULL), column_size(0),
+                                   column_capacity(0), next_cached(0),
+                                   cache_hits(0), cache_misses(0) {
+    for (int i = 0; i < small_size; i++)
+        small_gladiators[i] = group.small_gladiators[i];
+    for (int i = 0; i <= small_size; i++)
+        small_prefix[i] = group.small_prefix[i];
+    clearCache();
+    if (group.column_ids) {
+        int* ids = copyColumn(group.column_ids, group.column_size,
+                              group.column_capacity);
+        try {
+            column_scores = copyColumn(group.column_scores, group.column_size,
+                                       group.column_capacity);
+        } catch (std::bad_alloc&) {
+            delete[] ids;
+            throw;
+        }
+        column_ids = ids;
+        column_size = group.column_size;
+        column_capacity = group.column_capacity;
+    }
+}
+
+Group::~Group() {
+    delete[] column_ids;
+    delete[] column_scores;
+}
+
+Group& Group::operator=(const Group& group) {
+    if (this == &group)
+        return *this;
+    //all the copies are made before anything changes. Emptying a tree and
+    //absorbing into an empty one allocate nothing
+    int* ids = NULL;
+    int* scores = NULL;
+    if (group.column_ids) {
+        ids = copyColumn(group.column_ids, group.column_size,
+                         group.column_capacity);
+        try {
+            scores = copyColumn(group.column_scores, group.column_size,
+                                group.column_capacity);
+        } catch (std::bad_alloc&) {
+            delete[] ids;
+            throw;
+        }
+    }
+    IdTree new_gladiators;
+    try {
+        new_gladiators = group.gladiators;
+        by_score = group.by_score;
+    } catch (std::bad_alloc&) {
+        delete[] ids;
+        delete[] scores;
+        throw;
+    }
+    setColumns(ids, scores, group.column_size, group.column_capacity);
+    gladiators = IdTree();
+    gladiators.absorb(new_gladiators);
+    is_small = group.is_small;
+    small_size = group.small_size;
+    for (int i = 0; i < small_size; i++)
+        small_gladiators[i] = group.small_gladiators[i];
+    for (int i = 0; i <= small_size; i++)
+        small_prefix[i] = group.small_prefix[i];
+    small_version++;
+    id = group.id;
+    clearCache();
+    return *this;
+}
+
+void Group::clearCache() {
+    for (int i = 0; i < GROUP_CACHE_SIZE; i++)
+        cache[i].query = CachedQuery::NONE;
+}
+
+bool Group::findCached(CachedQuery::Query query, int argument,
+                       long long* result) {
+    unsigned long version = getVersion();
+    for (int i = 0; i < GROUP_CACHE_SIZE; i++) {
+        if (cache[i].query == query && cache[i].argument == argument &&
+            cache[i].version == version) {
+            *result = cache[i].result;
+            cache_hits++;
+            return true;
+        }
+    }
+    cache_misses++;
+    return false;
+}
+
+void Group::addCached(CachedQuery::Query query, int argument,
+                      long long result) {
+    cache[next_cached].query = query;
+    cache[next_cached].argument = argument;
+    cache[next_cached].version = getVersion();
+    cache[next_cached].result = result;
+    next_cached = (next_cached + 1) % GROUP_CACHE_SIZE;
+}
+
+void Group::setObserver(GroupObserver* observer) {
+    this->observer = observer;
 }
 
 int Group::getID() const {
     return id;
-}
\ No newline at end of file
+}
+
+int Group::findSmall(int gladiator_id) const {
+    for (int i = 0; i < small_size; i++) {
+        if (small_gladiators[i].getId() == gladiator_id)
+            return i;
+    }
+    return -1;
+}
+
+int Group::countSmallLess(const ScoreKey& key) const {
+    int low = 0, high = small_size;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        const Gladiator& gladiator = small_gladiators[middle];
+        if (ScoreKey(gladiator.getScore(), gladiator.getId()) < key)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+void Group::insertSmall(const Gladiator& gladiator) {
+    assert(small_size < GROUP_SMALL_SIZE);
+    int index = countSmallLess(ScoreKey(gladiator.getScore(),
+                                        gladiator.getId()));
+    for (int i = small_size; i > index; i--)
+        small_gladiators[i] = small_gladiators[i - 1];
+    small_gladiators[index] = gladiator;
+    small_size++;
+    updatePrefix(index);
+}
+
+void Group::removeSmall(int index) {
+    for (int i = index; i + 1 < small_size; i++)
+        small_gladiators[i] = small_gladiators[i + 1];
+    small_size--;
+    updatePrefix(index);
+}
+
+void Group::updatePrefix(int index) {
+    for (int i = index; i < small_size; i++)
+        small_prefix[i + 1] = small_prefix[i] + small_gladiators[i].getScore();
+    small_version++;
+}
+
+void Group::smallIdOrder(int* order) const {
+    for (int i = 0; i < small_size; i++)
+        order[i] = i;
+    std::sort(order, order + small_size, CompareIds(small_gladiators));
+}
+
+void Group::promote() {
+    assert(is_small);
+    int order[GROUP_SMALL_SIZE];
+    smallIdOrder(order);
+    Gladiator by_id[GROUP_SMALL_SIZE];
+    int ids[GROUP_SMALL_SIZE];
+    int scores[GROUP_SMALL_SIZE];
+    ScoreKey keys[GROUP_SMALL_SIZE];
+    for (int i = 0; i < small_size; i++) {
+        by_id[i] = small_gladiators[order[i]];
+        ids[i] = by_id[i].getId();
+        scores[i] = by_id[i].getScore();
+    }
+    //built aside and absorbed into the empty trees, which allocates nothing
+    IdTree new_gladiators;
+    new_gladiators.buildFromSorted(by_id, ids, scores, small_size);
+    for (int i = 0; i < small_size; i++) {
+        const Gladiator& gladiator = small_gladiators[i];
+        keys[i] = ScoreKey(gladiator.getScore(), gladiator.getId());
+        scores[i] = gladiator.getScore();
+    }
+    ScoreTree new_by_score;
+    new_by_score.buildFromSorted(small_gladiators, keys, scores, small_size);
+    gladiators.absorb(new_gladiators);
+    by_score.absorb(new_by_score);
+    is_small = false;
+    small_size = 0;
+    small_prefix[0] = 0;
+    small_version++;
+}
+
+void Group::demote() {
+    assert(!is_small && by_score.getSize() <= GROUP_SMALL_SIZE);
+    small_size = 0;
+    const ScoreTree& ranked = by_score;
+    for (ScoreTree::ConstIterator it = ranked.begin();
+         it != ranked.end(); ++it)
+        small_gladiators[small_size++] = *it;
+    updatePrefix(0);
+    gladiators = IdTree();
+    by_score = ScoreTree();
+    is_small = true;
+}
+
+int Group::columnIndex(int gladiator_id) const {
+    int low = 0, high = column_size;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (column_ids[middle] < gladiator_id)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+void Group::reserveColumns(int n) {
+    if (column_ids == NULL || n <= column_capacity)
+        return;
+    int capacity = column_capacity * 2 > n ? column_capacity * 2 : n;
+    int* ids = copyColumn(column_ids, column_size, capacity);
+    int* scores;
+    try {
+        scores = copyColumn(column_scores, column_size, capacity);
+    } catch (std::bad_alloc&) {
+        delete[] ids;
+        throw;
+    }
+    setColumns(ids, scores, column_size, capacity);
+}
+
+void Group::setColumns(int* ids, int* scores, int size, int capacity) {
+    delete[] column_ids;
+    delete[] column_scores;
+    column_ids = ids;
+    column_scores = scores;
+    column_size = ids ? size : 0;
+    column_capacity = ids ? capacity : 0;
+}
+
+void Group::columnInsert(int gladiator_id, int score) {
+    if (column_ids == NULL)
+        return;
+    assert(column_size < column_capacity);
+    int index = columnIndex(gladiator_id);
+    int moved = column_size - index;
+    memmove(column_ids + index + 1, column_ids + index, moved * sizeof(int));
+    memmove(column_scores + index + 1, column_scores + index,
+            moved * sizeof(int));
+    column_ids[index] = gladiator_id;
+    column_scores[index] = score;
+    column_size++;
+}
+
+void Group::columnRemove(int gladiator_id) {
+    if (column_ids == NULL)
+        return;
+    int index = columnIndex(gladiator_id);
+    assert(index < column_size && column_ids[index] == gladiator_id);
+    int moved = column_size - index - 1;
+    memmove(column_ids + index, column_ids + index + 1, moved * sizeof(int));
+    memmove(column_scores + index, column_scores + index + 1,
+            moved * sizeof(int));
+    column_size--;
+}
+
+void Group::columnSetScore(int gladiator_id, int score) {
+    if (column_ids == NULL)
+        return;
+    int index = columnIndex(gladiator_id);
+    assert(index < column_size && column_ids[index] == gladiator_id);
+    column_scores[index] = score;
+}
+
+void Group::enableColumns() {
+    if (column_ids)
+        return;
+    int n = getNumOfGladiators();
+    int capacity = n > GROUP_COLUMN_MIN_CAPACITY ? n :
+                   GROUP_COLUMN_MIN_CAPACITY;
+    int* ids = new int[capacity];
+    int* scores;
+    try {
+        scores = new int[capacity];
+    } catch (std::bad_alloc&) {
+        delete[] ids;
+        throw;
+    }
+    CopyColumns copy(ids, scores);
+    forEachGladiator(copy);
+    setColumns(ids, scores, n, capacity);
+}
+
+void Group::disableColumns() {
+    setColumns(NULL, NULL, 0, 0);
+}
+
+bool Group::hasColumns() const {
+    return column_ids != NULL;
+}
+
+const int* Group::getColumnIds() const {
+    return column_ids;
+}
+
+const int* Group::getColumnScores() const {
+    return column_scores;
+}
+
+unsigned long Group::getVersion() const {
+    //every change of the tree gladiators changes the score tree. Both
+    //counters only grow, so their sum changes with either
+    return by_score.getVersion() + small_version;
+}
+
+int Group::getNumOfGladiators() const {
+    return is_small ? small_size : gladiators.getSize();
+}
+
+void Group::addGladiator(int gladiator_id, int score) {
+    if (gladiator_id < 0 || score < 0)
+        throw InvalidInput();
+    Gladiator gladiator(gladiator_id, score);
+    if (is_small && findSmall(gladiator_id) >= 0)
+        throw KeyAlreadyExist();
+    //growing the columns and promoting aren't visible, they may stay done
+    //if the add fails
+    reserveColumns(getNumOfGladiators() + 1);
+    if (is_small && small_size == GROUP_SMALL_SIZE)
+        promote();
+    if (is_small) {
+        insertSmall(gladiator);
+    } else {
+        try {
+            gladiators.insert(gladiator, gladiator_id, score);
+        } catch (IdTree::KeyAlreadyExist&) {
+            throw KeyAlreadyExist();
+        }
+        try {
+            by_score.insert(gladiator, ScoreKey(score, gladiator_id), score);
+        } catch (std::bad_alloc&) {
+            gladiators.remove(gladiator_id);
+            throw;
+        }
+    }
+    columnInsert(gladiator_id, score);
+    if (observer == NULL)
+        return;
+    try {
+        observer->gladiatorAdded(*this, gladiator_id, score);
+    } catch (...) {
+        erase(gladiator_id, score);
+        throw;
+    }
+}
+
+void Group::erase(int gladiator_id, int score) {
+    if (is_small) {
+        removeSmall(findSmall(gladiator_id));
+    } else {
+        gladiators.remove(gladiator_id);
+        by_score.remove(ScoreKey(score, gladiator_id));
+        if (gladiators.getSize() <= GROUP_SMALL_DEMOTE_SIZE)
+            demote();
+    }
+    columnRemove(gladiator_id);
+}
+
+void Group::removeGladiator(int gladiator_id) {
+    int score = getScore(gladiator_id);
+    erase(gladiator_id, score);
+    if (observer)
+        observer->gladiatorRemoved(*this, gladiator_id, score);
+}
+
+void Group::updateScore(int gladiator_id, int score) {
+    if (score < 0)
+        throw InvalidInput();
+    int old_score = getScore(gladiator_id);
+    if (old_score == score)
+        return;
+    Gladiator gladiator(gladiator_id, score);
+    if (is_small) {
+        //nothing to allocate, the observer is told before anything changes
+        if (observer)
+            observer->scoreUpdated(*this, gladiator_id, old_score, score);
+        removeSmall(findSmall(gladiator_id));
+        insertSmall(gladiator);
+        columnSetScore(gladiator_id, score);
+        return;
+    }
+    //the only allocation and the observer come first, so a failure of
+    //either leaves the group as it was
+    by_score.insert(gladiator, ScoreKey(score, gladiator_id), score);
+    if (observer) {
+        try {
+            observer->scoreUpdated(*this, gladiator_id, old_score, score);
+        } catch (...) {
+            by_score.remove(ScoreKey(score, gladiator_id));
+            throw;
+        }
+    }
+    by_score.remove(ScoreKey(old_score, gladiator_id));
+    gladiators.update(gladiator_id, gladiator, score);
+    columnSetScore(gladiator_id, score);
+}
+
+int Group::getScore(int gladiator_id) {
+    if (is_small) {
+        int index = findSmall(gladiator_id);
+        if (index < 0)
+            throw KeyNotFound();
+        return small_gladiators[index].getScore();
+    }
+    try {
+        return gladiators.find(gladiator_id).getScore();
+    } catch (IdTree::KeyNotFound&) {
+        throw KeyNotFound();
+    }
+}
+
+long long Group::sumOfTopK(int k) {
+    if (k < 0 || k > getNumOfGladiators())
+        throw InvalidInput();
+    if (is_small)
+        return small_prefix[k];
+    long long result;
+    if (findCached(CachedQuery::TOP_K, k, &result))
+        return result;
+    result = by_score.prefixWeight(k);
+    addCached(CachedQuery::TOP_K, k, result);
+    return result;
+}
+
+int Group::countAbove(int score) {
+    if (column_ids)
+        return reduce::countAbove(column_scores, column_size, score);
+    //ids are non negative, so (score, -1) precedes every gladiator with score
+    ScoreKey key(score, INVALID_KEY);
+    if (is_small)
+        return countSmallLess(key);
+    long long result;
+    if (findCached(CachedQuery::COUNT_ABOVE, score, &result))
+        return (int) result;
+    result = by_score.countLess(key);
+    addCached(CachedQuery::COUNT_ABOVE, score, result);
+    return (int) result;
+}
+
+long long Group::sumOfScores() {
+    if (column_ids)
+        return reduce::sum(column_scores, column_size);
+    return sumOfTopK(getNumOfGladiators());
+}
+
+int Group::minScore() {
+    if (getNumOfGladiators() == 0)
+        throw KeyNotFound();
+    if (column_ids)
+        return reduce::min(column_scores, column_size);
+    //the score order is descending, the lowest score is last
+    if (is_small)
+        return small_gladiators[small_size - 1].getScore();
+    return by_score.findMax().getScore();
+}
+
+int Group::maxScore() {
+    if (getNumOfGladiators() == 0)
+        throw KeyNotFound();
+    if (column_ids)
+        return reduce::max(column_scores, column_size);
+    if (is_small)
+        return small_gladiators[0].getScore();
+    return by_score.findMin().getScore();
+}
+
+long long Group::getCacheHits() const {
+    return cache_hits;
+}
+
+long long Group::getCacheMisses() const {
+    return cache_misses;
+}
+
+void Group::absorb(Group& group) {
+    if (this == &group)
+        return;
+    if (column_ids == NULL) {
+        absorbGladiators(group);
+        group.column_size = 0;
+        return;
+    }
+    //the merged columns are allocated before anything changes
+    int total = column_size + group.getNumOfGladiators();
+    int capacity = total > column_capacity ? total : column_capacity;
+    int* ids = NULL;
+    int* scores = NULL;
+    int* theirs = NULL;
+    int* their_scores = NULL;
+    try {
+        ids = new int[capacity];
+        scores = new int[capacity];
+        theirs = new int[total - column_size + 1];
+        their_scores = new int[total - column_size + 1];
+        CopyColumns copy(theirs, their_scores);
+        group.forEachGladiator(copy);
+        absorbGladiators(group);
+    } catch (...) {
+        delete[] ids;
+        delete[] scores;
+        delete[] theirs;
+        delete[] their_scores;
+        throw;
+    }
+    int mine = 0, their = 0;
+    for (int i = 0; i < total; i++) {
+        if (their == total - column_size ||
+            (mine < column_size && column_ids[mine] < theirs[their])) {
+            ids[i] = column_ids[mine];
+            scores[i] = column_scores[mine++];
+        } else {
+            ids[i] = theirs[their];
+            scores[i] = their_scores[their++];
+        }
+    }
+    setColumns(ids, scores, total, capacity);
+    group.column_size = 0;
+    delete[] theirs;
+    delete[] their_scores;
+}
+
+void Group::absorbGladiators(Group& group) {
+    int total = getNumOfGladiators() + group.getNumOfGladiators();
+    if (is_small && group.is_small && total <= GROUP_SMALL_SIZE) {
+        for (int i = 0; i < group.small_size; i++) {
+            if (findSmall(group.small_gladiators[i].getId()) >= 0)
+                throw KeyAlreadyExist();
+        }
+        //merges from the back, into the free end of this group's array
+        int mine = small_size - 1;
+        int theirs = group.small_size - 1;
+        for (int i = total - 1; theirs >= 0; i--) {
+            const Gladiator& first = small_gladiators[mine < 0 ? 0 : mine];
+            const Gladiator& second = group.small_gladiators[theirs];
+            if (mine >= 0 && ScoreKey(second.getScore(), second.getId()) <
+                             ScoreKey(first.getScore(), first.getId()))
+                small_gladiators[i] = small_gladiators[mine--];
+            else
+                small_gladiators[i] = group.small_gladiators[theirs--];
+        }
+        small_size = total;
+        updatePrefix(0);
+        group.small_size = 0;
+        group.updatePrefix(0);
+        return;
+    }
+    //promoting is not visible, so it may stay done if the absorb fails
+    if (is_small)
+        promote();
+    if (group.is_small)
+        group.promote();
+    try {
+        gladiators.absorb(group.gladiators);
+    } catch (IdTree::KeyAlreadyExist&) {
+        throw KeyAlreadyExist();
+    }
+    //the ids are distinct, so are the (score, id) keys
+    by_score.absorb(group.by_score);
+    group.demote();
+}
+
+void Group::loadGladiators(const Gladiator* sorted, int n) {
+    for (int i = 0; i < n; i++) {
+        if (sorted[i].getId() < 0 || sorted[i].getScore() < 0 ||
+            (i > 0 && sorted[i - 1].getId() >= sorted[i].getId()))
+            throw InvalidInput();
+    }
+    int* ids = NULL;
+    int* scores = NULL;
+    Gladiator* ranked = NULL;
+    ScoreKey* keys = NULL;
+    int* new_column_ids = NULL;
+    int* new_column_scores = NULL;
+    int capacity = n > GROUP_COLUMN_MIN_CAPACITY ? n :
+                   GROUP_COLUMN_MIN_CAPACITY;
+    //built aside, so a failure leaves the group as it was
+    IdTree new_gladiators;
+    ScoreTree new_by_score;
+    try {
+        if (column_ids) {
+            new_column_ids = new int[capacity];
+            new_column_scores = new int[capacity];
+            for (int i = 0; i < n; i++) {
+                new_column_ids[i] = sorted[i].getId();
+                new_column_scores[i] = sorted[i].getScore();
+            }
+        }
+        ids = new int[n > 0 ? n : 1];
+        scores = new int[n > 0 ? n : 1];
+        for (int i = 0; i < n; i++) {
+            ids[i] = sorted[i].getId();
+            scores[i] = sorted[i].getScore();
+        }
+        if (n > GROUP_SMALL_SIZE)
+            new_gladiators.buildFromSorted(sorted, ids, scores, n);
+
+        ranked = new Gladiator[n > 0 ? n : 1];
+        keys = new ScoreKey[n > 0 ? n : 1];
+        std::copy(sorted, sorted + n, ranked);
+        std::sort(ranked, ranked + n, CompareScores());
+        for (int i = 0; i < n; i++) {
+            keys[i] = ScoreKey(ranked[i].getScore(), ranked[i].getId());
+            scores[i] = ranked[i].getScore();
+        }
+        if (n > GROUP_SMALL_SIZE)
+            new_by_score.buildFromSorted(ranked, keys, scores, n);
+    } catch (std::bad_alloc&) {
+        delete[] ids;
+        delete[] scores;
+        delete[] ranked;
+        delete[] keys;
+        delete[] new_column_ids;
+        delete[] new_column_scores;
+        throw;
+    }
+    if (column_ids)
+        setColumns(new_column_ids, new_column_scores, n, capacity);
+    gladiators = IdTree();
+    by_score = ScoreTree();
+    if (n > GROUP_SMALL_SIZE) {
+        gladiators.absorb(new_gladiators);
+        by_score.absorb(new_by_score);
+        is_small = false;
+        small_size = 0;
+        small_version++;
+    } else {
+        is_small = true;
+        small_size = n;
+        for (int i = 0; i < n; i++)
+            small_gladiators[i] = ranked[i];
+        updatePrefix(0);
+    }
+    delete[] ids;
+    delete[] scores;
+    delete[] ranked;
+    delete[] keys;
+}
@@ -4,22 +4,324 @@
 
 #include "splayTree.h"
 #include "Gladiator.h"
+#include "ScoreKey.h"
+#include "GroupObserver.h"
+#include "scoreReduce.h"
 
 using namespace trees;
 
+/**number of query results a group remembers */
+#define GROUP_CACHE_SIZE 4
+
+/**largest number of gladiators a group keeps inline, without trees */
+#ifndef GROUP_SMALL_SIZE
+#define GROUP_SMALL_SIZE 16
+#endif
+
+/**a group with trees goes back inline when it shrinks to this size. Below
+ * GROUP_SMALL_SIZE, so adding and removing around the threshold doesn't
+ * rebuild the trees every time */
+#define GROUP_SMALL_DEMOTE_SIZE (GROUP_SMALL_SIZE / 2)
+
+/**initial capacity of the id and score columns */
+#define GROUP_COLUMN_MIN_CAPACITY 16
+
+/**---------------------------GROUP----------------------------------
+ * The gladiators of a group, by id and by (score desc, id asc).
+ * Up to GROUP_SMALL_SIZE gladiators are kept inline in the group: an array
+ * sorted by ScoreKey with the prefix sums of its scores, so sumOfTopK is
+ * one read and the rest is a scan of a few cache lines, with no node
+ * allocated. Past the threshold the gladiators move to two splay trees,
+ * and back inline once the group shrinks to GROUP_SMALL_DEMOTE_SIZE.
+ * Which one holds the gladiators isn't visible through the interface.
+ * Optionally (enableColumns) the ids and the scores are also kept in two
+ * plain arrays sorted by id, for scans of the whole group. */
 class Group {
+    /**the keys of the trees, read off the gladiators themselves, so the
+     * nodes don't keep a second copy of the id and the score */
+    class IdOf {
+    public:
+        int operator()(const Gladiator& gladiator) const {
+            return gladiator.getId();
+        }
+    };
+
+    class ScoreKeyOf {
+    public:
+        ScoreKey operator()(const Gladiator& gladiator) const {
+            return ScoreKey(gladiator.getScore(), gladiator.getId());
+        }
+    };
+
+    typedef Splay<Gladiator, int, ThreeWayCompare<int>,
+            ExtractedKey<Gladiator, int, IdOf> > IdTree;
+    typedef Splay<Gladiator, ScoreKey, ThreeWayCompare<ScoreKey>,
+            ExtractedKey<Gladiator, ScoreKey, ScoreKeyOf> > ScoreTree;
+
+    /**a remembered query result, valid while the score tree's version is
+     * the one it was computed at */
+    struct CachedQuery {
+        enum Query {
+            NONE, TOP_K, COUNT_ABOVE
+        };
+        Query query;
+        int argument;
+        unsigned long version;
+        long long result;
+    };
+
     int id;
-    Splay<Gladiator, int> gladiators;
+    IdTree gladiators; //key - gladiator id, value - score
+    ScoreTree by_score; //key - (score, id), value - score
+    GroupObserver* observer;
+    bool is_small; //the gladiators are inline, and the trees are empty
+    int small_size;
+    Gladiator small_gladiators[GROUP_SMALL_SIZE]; //by ScoreKey
+    long long small_prefix[GROUP_SMALL_SIZE + 1]; //sums of the first scores
+    unsigned long small_version; //changes of the inline gladiators
+    int* column_ids; //by increasing id, NULL while the columns are off
+    int* column_scores; //the score of column_ids[i] at i
+    int column_size;
+    int column_capacity;
+    CachedQuery cache[GROUP_CACHE_SIZE];
+    int next_cached; //the entry the next result replaces
+    long long cache_hits;
+    long long cache_misses;
+
+    /**@return true and sets result if the query is cached and valid */
+    bool findCached(CachedQuery::Query query, int argument, long long* result);
+
+    /**remembers a result, replacing the entries round robin */
+    void addCached(CachedQuery::Query query, int argument, long long result);
+
+    /**forgets every result */
+    void clearCache();
+
+    /**@return the inline index of the gladiator, or -1 */
+    int findSmall(int gladiator_id) const;
+
+    /**@return the number of inline gladiators whose key is less than key */
+    int countSmallLess(const ScoreKey& key) const;
+
+    /**puts the gladiator inline in its place. There must be room */
+    void insertSmall(const Gladiator& gladiator);
+
+    /**takes the inline gladiator at index out */
+    void removeSmall(int index);
+
+    /**recomputes small_prefix from index on */
+    void updatePrefix(int index);
+
+    /**sets order to the inline indices by increasing id */
+    void smallIdOrder(int* order) const;
+
+    /**moves the inline gladiators into the trees. A failure leaves the
+     * group inline and unchanged */
+    void promote();
+
+    /**moves the gladiators from the trees inline, there must be room.
+     * Allocates nothing */
+    void demote();
+
+    /**@return the column index of the first id not less than gladiator_id */
+    int columnIndex(int gladiator_id) const;
+
+    /**makes room in the columns, if they are on, for n gladiators. A
+     * failure leaves them as they were */
+    void reserveColumns(int n);
+
+    /**replaces the columns with ids and scores, which the group now owns */
+    void setColumns(int* ids, int* scores, int size, int capacity);
+
+    /**keep the columns, if they are on, in step with the gladiators. There
+     * must be room for an insert */
+    void columnInsert(int gladiator_id, int score);
+    void columnRemove(int gladiator_id);
+    void columnSetScore(int gladiator_id, int score);
+
+    /**takes the gladiator out, without telling the observer */
+    void erase(int gladiator_id, int score);
+
+    /**absorb, apart from the columns */
+    void absorbGladiators(Group& group);
+
 public:
     Group();
     explicit Group(int id);
+
+    /**COPY CONSTRUCTOR
+     * copies the gladiators. The copy has no observer */
+    Group(const Group& group);
+
+    /**ASSIGNMENT OPERATOR
+     * copies the gladiators, keeps the group's own observer. The observer
+     * isn't told, assign only to groups that are not observed */
+    Group& operator=(const Group& group);
+
+    ~Group();
+
     int getID() const;
 
+    /**GET VERSION
+     * @return a counter that changes with every change of the gladiators or
+     *         their scores, inline or in the trees. Queries don't change it */
+    unsigned long getVersion() const;
+
+    /**SET OBSERVER
+     * @param observer - gets every following change of the gladiators, or
+     *                   NULL. Not owned by the group */
+    void setObserver(GroupObserver* observer);
+
+    /**GET NUM OF GLADIATORS
+     * @return the number of gladiators in the group */
+    int getNumOfGladiators() const;
+
+    /**ADD GLADIATOR
+     * @param gladiator_id - non negative
+     * @param score - non negative
+     * @exception InvalidInput - a negative id or score
+     * @exception KeyAlreadyExist - the gladiator is already in the group
+     * Whatever the observer throws is rethrown, with the group unchanged */
+    void addGladiator(int gladiator_id, int score);
+
+    /**REMOVE GLADIATOR
+     * @exception KeyNotFound - the gladiator isn't in the group */
+    void removeGladiator(int gladiator_id);
+
+    /**UPDATE SCORE
+     * @param score - the gladiator's new score, non negative
+     * @exception InvalidInput - a negative score
+     * @exception KeyNotFound - the gladiator isn't in the group
+     * Whatever the observer throws is rethrown, with the group unchanged */
+    void updateScore(int gladiator_id, int score);
+
+    /**GET SCORE
+     * @exception KeyNotFound - the gladiator isn't in the group */
+    int getScore(int gladiator_id);
+
+    /**SUM OF TOP K
+     * sums the scores of the k best gladiators (ties go to the lower id), in
+     * a single descent of the score tree. O(log n) amortized, O(1) for an
+     * inline group or if asked since the last change (see getCacheHits).
+     * @param k - 0 <= k <= number of gladiators
+     * @exception InvalidInput - k is out of range */
+    long long sumOfTopK(int k);
+
+    /**COUNT ABOVE
+     * counts the gladiators with a score strictly higher than score, in a
+     * single descent of the score tree. O(log n) amortized, O(1) if asked
+     * since the last change. A binary search for an inline group. With the
+     * columns on, a vector scan of the scores, which doesn't restructure
+     * the tree. */
+    int countAbove(int score);
+
+    /**SUM OF SCORES
+     * @return the sum of all the scores. A vector scan of the scores with
+     *         the columns on, sumOfTopK of everyone otherwise */
+    long long sumOfScores();
+
+    /**MIN SCORE / MAX SCORE
+     * @return the lowest / highest score. A vector scan of the scores with
+     *         the columns on, an end of the score order otherwise
+     * @exception KeyNotFound - the group is empty */
+    int minScore();
+    int maxScore();
+
+    /**ENABLE COLUMNS
+     * keeps the ids and the scores in two arrays sorted by id, next to the
+     * ordered indexes, and in step with every change (a memmove per add or
+     * remove). Scans of the whole group then read memory in order, a
+     * vector at a time (see scoreReduce.h), instead of node by node.
+     * O(n) to build, nothing if they are on already
+     * @exception std::bad_alloc - the columns stay off */
+    void enableColumns();
+
+    /**DISABLE COLUMNS
+     * frees the columns */
+    void disableColumns();
+
+    bool hasColumns() const;
+
+    /**GET COLUMN IDS / SCORES
+     * @return the ids by increasing id, and the scores in the same order,
+     *         getNumOfGladiators() of each. NULL while the columns are
+     *         off. Valid until the next change of the group */
+    const int* getColumnIds() const;
+    const int* getColumnScores() const;
+
+    /**GET CACHE HITS / MISSES
+     * the last GROUP_CACHE_SIZE results of sumOfTopK and countAbove are
+     * kept with the version they were computed at, and a repeated query of
+     * the same version is answered from them without touching the tree.
+     * Inline groups answer from their array and don't use the cache.
+     * @return the number of queries answered from the cache, and the
+     *         number that went to the tree */
+    long long getCacheHits() const;
+    long long getCacheMisses() const;
+
+    /**FOR EACH GLADIATOR
+     * apply the function on each of the group's gladiators, by increasing id
+     * @tparam Func - function object that overload operator() and has one
+     *                parameter of type Gladiator */
+    template<class Func>
+    void forEachGladiator(Func& function);
+    template<class Func>
+    void forEachGladiator(Func& function) const;
+
+    /**ABSORB
+     * moves all of group's gladiators into this group, leaving group empty,
+     * in O(n + m) (see BST::absorb). Nothing is copied or allocated.
+     * The observers aren't told, the gladiators keep their scores.
+     * @param group - another group
+     * @exception KeyAlreadyExist - a gladiator is in both groups. Neither
+     *                              group is changed */
+    void absorb(Group& group);
+
+    /**LOAD GLADIATORS
+     * replaces the group's gladiators, in O(n)
+     * @param sorted - the gladiators sorted by increasing id
+     * @param n - number of gladiators
+     * @exception InvalidInput - the ids aren't strictly increasing, or an id
+     *                           or a score is negative
+     * The observer isn't told, load only groups that are not observed */
+    void loadGladiators(const Gladiator* sorted, int n);
 
 
     class InvalidInput : public std::exception{
     };
+
+    class KeyAlreadyExist : public std::exception{
+    };
+
+    class KeyNotFound : public std::exception{
+    };
 };
 
+template<class Func>
+void Group::forEachGladiator(Func& function) {
+    if (!is_small) {
+        gladiators.inorderData(function);
+        return;
+    }
+    int order[GROUP_SMALL_SIZE];
+    smallIdOrder(order);
+    for (int i = 0; i < small_size; i++)
+        function(small_gladiators[order[i]]);
+}
+
+template<class Func>
+void Group::forEachGladiator(Func& function) const {
+    if (!is_small) {
+        gladiators.inorderData(function);
+        return;
+    }
+    int order[GROUP_SMALL_SIZE];
+    smallIdOrder(order);
+    for (int i = 0; i < small_size; i++) {
+        const Gladiator& gladiator = small_gladiators[order[i]];
+        function(gladiator);
+    }
+}
+
 
 #endif //DSWET2_GROUP_H
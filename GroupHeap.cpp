@@ -0,0 +1,133 @@
+
+#include "GroupHeap.h"
+
+GroupHeap::GroupHeap() : heap(new Entry[GROUP_HEAP_MIN_CAPACITY]), size(0),
+                         capacity(GROUP_HEAP_MIN_CAPACITY) {}
+
+GroupHeap::~GroupHeap() {
+    delete[] heap;
+}
+
+void GroupHeap::place(int index, const Entry& entry) {
+    heap[index] = entry;
+    *positions.find(entry.id) = index;
+}
+
+void GroupHeap::siftUp(int index) {
+    Entry entry = heap[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!less(entry, heap[parent]))
+            break;
+        place(index, heap[parent]);
+        index = parent;
+    }
+    place(index, entry);
+}
+
+void GroupHeap::siftDown(int index) {
+    Entry entry = heap[index];
+    while (true) {
+        int child = 2 * index + 1;
+        if (child >= size)
+            break;
+        if (child + 1 < size && less(heap[child + 1], heap[child]))
+            child++;
+        if (!less(heap[child], entry))
+            break;
+        place(index, heap[child]);
+        index = child;
+    }
+    place(index, entry);
+}
+
+void GroupHeap::resize(int new_capacity) {
+    Entry* new_heap = new Entry[new_capacity];
+    for (int i = 0; i < size; i++)
+        new_heap[i] = heap[i];
+    delete[] heap;
+    heap = new_heap;
+    capacity = new_capacity;
+}
+
+int GroupHeap::indexOf(int id) const {
+    const int* index = positions.find(id);
+    if (index == NULL)
+        throw KeyNotFound();
+    return *index;
+}
+
+void GroupHeap::insert(int id, long long key) {
+    if (positions.find(id) != NULL)
+        throw KeyAlreadyExist();
+    //the allocations come first, so a failure leaves the heap as it was
+    if (size == capacity)
+        resize(capacity * 2);
+    positions.insert(id, size);
+    heap[size].key = key;
+    heap[size].id = id;
+    size++;
+    siftUp(size - 1);
+}
+
+void GroupHeap::remove(int id) {
+    int index = indexOf(id);
+    positions.remove(id);
+    size--;
+    if (index < size) {
+        //the last entry fills the hole, and may belong above or below it
+        place(index, heap[size]);
+        if (index > 0 && less(heap[index], heap[(index - 1) / 2]))
+            siftUp(index);
+        else
+            siftDown(index);
+    }
+    if (capacity > GROUP_HEAP_MIN_CAPACITY && size * 4 < capacity) {
+        try {
+            resize(capacity / 2);
+        } catch (std::bad_alloc&) {
+            //shrinking is only an optimization, keep the current array
+        }
+    }
+}
+
+void GroupHeap::decreaseKey(int id, long long key) {
+    int index = indexOf(id);
+    if (key > heap[index].key)
+        throw InvalidInput();
+    heap[index].key = key;
+    siftUp(index);
+}
+
+void GroupHeap::increaseKey(int id, long long key) {
+    int index = indexOf(id);
+    if (key < heap[index].key)
+        throw InvalidInput();
+    heap[index].key = key;
+    siftDown(index);
+}
+
+void GroupHeap::setKey(int id, long long key) {
+    if (key < getKey(id))
+        decreaseKey(id, key);
+    else
+        increaseKey(id, key);
+}
+
+long long GroupHeap::getKey(int id) const {
+    return heap[indexOf(id)].key;
+}
+
+int GroupHeap::getMin() const {
+    if (size == 0)
+        throw Empty();
+    return heap[0].id;
+}
+
+bool GroupHeap::contains(int id) const {
+    return positions.find(id) != NULL;
+}
+
+int GroupHeap::getSize() const {
+    return size;
+}
@@ -0,0 +1,106 @@
+
+#ifndef DSWET2_GROUPHEAP_H
+#define DSWET2_GROUPHEAP_H
+
+#include "IntMap.h"
+#include <exception>
+
+/**initial number of entries the heap has room for */
+#define GROUP_HEAP_MIN_CAPACITY 16
+
+/**---------------------------GROUP HEAP----------------------------------
+ * An indexed binary min-heap of group ids, ordered by a long long key and
+ * then by id. The position of each id in the heap array is kept in an
+ * IntMap, so the key of any group can be changed or the group removed by
+ * its id in O(log n), without searching the heap. The minimum is read in
+ * O(1).
+ * The array grows by doubling and shrinks to half when a quarter full. */
+class GroupHeap {
+    struct Entry {
+        long long key;
+        int id;
+    };
+
+    Entry* heap;
+    int size;
+    int capacity;
+    IntMap<int> positions; //key - group id, value - index in heap
+
+    GroupHeap(const GroupHeap&);
+    GroupHeap& operator=(const GroupHeap&);
+
+    static bool less(const Entry& a, const Entry& b) {
+        return a.key != b.key ? a.key < b.key : a.id < b.id;
+    }
+
+    /**moves the entry at index up or down to its place */
+    void siftUp(int index);
+    void siftDown(int index);
+
+    /**places entry at index and records the position */
+    void place(int index, const Entry& entry);
+
+    /**moves the entries to an array of new_capacity entries */
+    void resize(int new_capacity);
+
+    /**@return the index of id
+     * @exception KeyNotFound - id isn't in the heap */
+    int indexOf(int id) const;
+
+public:
+    GroupHeap();
+    ~GroupHeap();
+
+    /**INSERT
+     * @exception KeyAlreadyExist - id is already in the heap */
+    void insert(int id, long long key);
+
+    /**REMOVE
+     * @exception KeyNotFound - id isn't in the heap */
+    void remove(int id);
+
+    /**DECREASE KEY
+     * @exception KeyNotFound - id isn't in the heap
+     * @exception InvalidInput - key is larger than id's key */
+    void decreaseKey(int id, long long key);
+
+    /**INCREASE KEY
+     * @exception KeyNotFound - id isn't in the heap
+     * @exception InvalidInput - key is smaller than id's key */
+    void increaseKey(int id, long long key);
+
+    /**SET KEY
+     * decreases or increases id's key to key
+     * @exception KeyNotFound - id isn't in the heap */
+    void setKey(int id, long long key);
+
+    /**GET KEY
+     * @exception KeyNotFound - id isn't in the heap */
+    long long getKey(int id) const;
+
+    /**GET MIN
+     * @return the id with the smallest key, the smallest id on a tie
+     * @exception Empty - the heap is empty */
+    int getMin() const;
+
+    bool contains(int id) const;
+
+    int getSize() const;
+
+    class GroupHeapException : public std::exception {
+    };
+
+    class InvalidInput : public GroupHeapException {
+    };
+
+    class KeyNotFound : public GroupHeapException {
+    };
+
+    class KeyAlreadyExist : public GroupHeapException {
+    };
+
+    class Empty : public GroupHeapException {
+    };
+};
+
+#endif //DSWET2_GROUPHEAP_H
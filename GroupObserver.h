@@ -0,0 +1,28 @@
+
+#ifndef DSWET2_GROUPOBSERVER_H
+#define DSWET2_GROUPOBSERVER_H
+
+class Group;
+
+/**---------------------------GROUP OBSERVER----------------------------------
+ * Interface of an index that mirrors the gladiators of many groups (see
+ * Colosseum). A group with an observer reports every change of its
+ * gladiators to it, right after the change was made to the group. If the
+ * observer throws, the group undoes the change and rethrows, so the group
+ * and its observer never disagree. */
+class GroupObserver {
+public:
+    virtual ~GroupObserver() {}
+
+    virtual void gladiatorAdded(const Group& group, int gladiator_id,
+                                int score) = 0;
+
+    /**must not throw */
+    virtual void gladiatorRemoved(const Group& group, int gladiator_id,
+                                  int score) = 0;
+
+    virtual void scoreUpdated(const Group& group, int gladiator_id,
+                              int old_score, int new_score) = 0;
+};
+
+#endif //DSWET2_GROUPOBSERVER_H
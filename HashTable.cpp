@@ -0,0 +1,610 @@
+//
+// Created by or.guz on 03-Jan-18.
+//
+
+#include "HashTable.h"
+#include <string.h>
+#if __cplusplus >= 201103L
+#include <thread>
+#include <vector>
+#endif
+
+/**@return the cpu time of the calling thread in nanoseconds. Unlike clock(),
+ * the time other threads (e.g. other stripes of a ConcurrentHashTable) run
+ * meanwhile isn't counted */
+static long long threadCpuTime() {
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return (long long) now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+HashTable::HashTable() : array_size(HASH_TABLE_MIN_SIZE), num_of_items(0),
+                         num_of_deleted(0), ctrl(NULL), slots(NULL),
+                         num_of_rehashes(0), rehash_time(0) {
+    allocate();
+}
+
+HashTable::HashTable(const int* id_array, int n, int num_threads) :
+        array_size(0), num_of_items(0), num_of_deleted(0), ctrl(NULL),
+        slots(NULL), num_of_rehashes(0), rehash_time(0) {
+    if (n <= 0)
+        throw InvalidSize();
+    array_size = capacityFor(n);
+    for (int i = 0; i < n; i++) {
+        if (id_array[i] < 0)
+            throw Group::InvalidInput();
+    }
+    allocate();
+    bool unique;
+    try {
+        unique = buildFromIds(id_array, n, num_threads);
+    } catch (std::bad_alloc&) {
+        clear();
+        throw;
+    }
+    if (!unique) {
+        clear();
+        throw KeyAlreadyExist();
+    }
+    assert(num_of_items == n);
+    recountProbes();
+}
+
+int HashTable::capacityFor(int n) {
+    if (n > HASH_TABLE_MAX_SIZE / 2)
+        throw InvalidSize();
+    int size = HASH_TABLE_MIN_SIZE;
+    while (size < n * 2)
+        size *= 2;
+    return size;
+}
+
+void HashTable::allocate() {
+    ctrl = new signed char[array_size];
+    try {
+        slots = new Group* [array_size];
+    } catch (std::bad_alloc&) {
+        delete[] ctrl;
+        ctrl = NULL;
+        throw;
+    }
+    memset(ctrl, swiss::EMPTY, array_size);
+    for (int i = 0; i < HASH_TABLE_PROBE_HISTOGRAM; i++)
+        probe_histogram[i] = 0;
+}
+
+void HashTable::clear() {
+    for (int i = 0; ctrl && i < array_size; i++) {
+        if (swiss::isFull(ctrl[i]))
+            delete slots[i];
+    }
+    delete[] ctrl;
+    delete[] slots;
+    ctrl = NULL;
+    slots = NULL;
+    num_of_items = 0;
+    num_of_deleted = 0;
+}
+
+bool HashTable::placeIds(const int* ids, int count, int first_group,
+                         int end_group, int* deferred, int* num_deferred) {
+    for (int i = 0; i < count; i++) {
+        unsigned int hash = swiss::mix(ids[i]);
+        swiss::ProbeSequence sequence(hash, numOfGroups());
+        while (true) {
+            int group = sequence.offset() / SWISS_GROUP_WIDTH;
+            if (group < first_group || group >= end_group) {
+                deferred[(*num_deferred)++] = ids[i];
+                break;
+            }
+            swiss::ProbeGroup probe(ctrl + sequence.offset());
+            swiss::BitMask candidates = probe.match(swiss::h2(hash));
+            while (candidates.any()) {
+                int slot = sequence.offset() + candidates.next();
+                if (slots[slot]->getID() == ids[i])
+                    return false;
+            }
+            swiss::BitMask empty = probe.matchEmpty();
+            if (empty.any()) {
+                int slot = sequence.offset() + empty.next();
+                slots[slot] = new Group(ids[i]);
+                ctrl[slot] = swiss::h2(hash);
+                break;
+            }
+            sequence.next();
+        }
+    }
+    return true;
+}
+
+bool HashTable::buildFromIds(const int* id_array, int n, int num_threads) {
+    int num_of_probe_groups = numOfGroups();
+    if (num_threads > n / HASH_TABLE_PARALLEL_MIN_ITEMS)
+        num_threads = n / HASH_TABLE_PARALLEL_MIN_ITEMS;
+    if (num_threads > num_of_probe_groups)
+        num_threads = num_of_probe_groups;
+#if __cplusplus >= 201103L
+    if (num_threads > 1) {
+        //counting sort of the ids by the thread that owns their first probe
+        //group. Thread t owns the probe groups [first[t], first[t + 1])
+        std::vector<int> first(num_threads + 1);
+        for (int t = 0; t <= num_threads; t++)
+            first[t] = (int) (((long long) t * num_of_probe_groups +
+                               num_threads - 1) / num_threads);
+        std::vector<int> start(num_threads + 1, 0);
+        std::vector<int> owner(n);
+        for (int i = 0; i < n; i++) {
+            int group = (int) (swiss::h1(swiss::mix(id_array[i])) &
+                               (num_of_probe_groups - 1));
+            owner[i] = (int) ((long long) group * num_threads /
+                              num_of_probe_groups);
+            start[owner[i] + 1]++;
+        }
+        for (int t = 0; t < num_threads; t++)
+            start[t + 1] += start[t];
+        std::vector<int> order(n);
+        std::vector<int> next(start.begin(), start.end() - 1);
+        for (int i = 0; i < n; i++)
+            order[next[owner[i]]++] = id_array[i];
+
+        //threads write disjoint probe groups. An id that would probe past
+        //its thread's range is deferred to a sequential pass
+        std::vector<int> deferred(n);
+        std::vector<int> num_deferred(num_threads, 0);
+        std::vector<char> unique(num_threads, 1);
+        std::vector<char> failed(num_threads, 0);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < num_threads; t++) {
+            workers.push_back(std::thread([&, t]() {
+                try {
+                    unique[t] = placeIds(&order[start[t]],
+                                         start[t + 1] - start[t], first[t],
+                                         first[t + 1], &deferred[start[t]],
+                                         &num_deferred[t]);
+                } catch (std::bad_alloc&) {
+                    failed[t] = 1;
+                }
+            }));
+        }
+        for (int t = 0; t < num_threads; t++)
+            workers[t].join();
+        for (int t = 0; t < num_threads; t++) {
+            if (failed[t])
+                throw std::bad_alloc();
+            if (!unique[t])
+                return false;
+        }
+        for (int t = 0; t < num_threads; t++) {
+            int ignored = 0;
+            if (!placeIds(&deferred[start[t]], num_deferred[t], 0,
+                          num_of_probe_groups, NULL, &ignored))
+                return false;
+        }
+        num_of_items = n;
+        return true;
+    }
+#endif
+    int ignored = 0;
+    if (!placeIds(id_array, n, 0, num_of_probe_groups, NULL, &ignored))
+        return false;
+    num_of_items = n;
+    return true;
+}
+
+HashTable::~HashTable() {
+    clear();
+}
+
+HashTable::HashTable(const HashTable& source) :
+        array_size(source.array_size), num_of_items(0), num_of_deleted(0),
+        ctrl(NULL), slots(NULL), num_of_rehashes(source.num_of_rehashes),
+        rehash_time(source.rehash_time), unions(source.unions) {
+    allocate();
+    try {
+        for (int i = 0; i < array_size; i++) {
+            if (swiss::isFull(source.ctrl[i])) {
+                slots[i] = new Group(*source.slots[i]);
+                ctrl[i] = source.ctrl[i];
+                num_of_items++;
+            } else {
+                ctrl[i] = source.ctrl[i];
+            }
+        }
+    } catch (std::bad_alloc&) {
+        clear();
+        throw;
+    }
+    num_of_deleted = source.num_of_deleted;
+    for (int i = 0; i < HASH_TABLE_PROBE_HISTOGRAM; i++)
+        probe_histogram[i] = source.probe_histogram[i];
+}
+
+HashTable& HashTable::operator=(const HashTable& source) {
+    if (this == &source)
+        return *this;
+    HashTable copy(source);
+    unions = copy.unions;
+    //take over the copy's arrays and leave it ours to delete
+    int saved_size = array_size;
+    signed char* saved_ctrl = ctrl;
+    Group** saved_slots = slots;
+    array_size = copy.array_size;
+    num_of_items = copy.num_of_items;
+    num_of_deleted = copy.num_of_deleted;
+    ctrl = copy.ctrl;
+    slots = copy.slots;
+    for (int i = 0; i < HASH_TABLE_PROBE_HISTOGRAM; i++)
+        probe_histogram[i] = copy.probe_histogram[i];
+    num_of_rehashes = copy.num_of_rehashes;
+    rehash_time = copy.rehash_time;
+    copy.array_size = saved_size;
+    copy.ctrl = saved_ctrl;
+    copy.slots = saved_slots;
+    return *this;
+}
+
+int HashTable::findSlot(int group_id, int* probe_length) const {
+    unsigned int hash = swiss::mix(group_id);
+    swiss::ProbeSequence sequence(hash, numOfGroups());
+    while (true) {
+        swiss::ProbeGroup probe(ctrl + sequence.offset());
+        swiss::BitMask candidates = probe.match(swiss::h2(hash));
+        while (candidates.any()) {
+            int slot = sequence.offset() + candidates.next();
+            if (slots[slot]->getID() == group_id) {
+                if (probe_length)
+                    *probe_length = sequence.index();
+                return slot;
+            }
+        }
+        if (probe.matchEmpty().any())
+            return -1;
+        sequence.next();
+    }
+}
+
+int HashTable::unionRoot(int group_id) const {
+    const UnionNode* node = unions.find(group_id);
+    if (node == NULL)
+        return -1;
+    while (node->parent != group_id) {
+        group_id = node->parent;
+        node = unions.find(group_id);
+    }
+    return group_id;
+}
+
+void HashTable::compressPath(int group_id) {
+    int root = unionRoot(group_id);
+    while (group_id != root) {
+        UnionNode* node = unions.find(group_id);
+        group_id = node->parent;
+        node->parent = root;
+    }
+}
+
+int HashTable::resolveSlot(int group_id, int* probe_length) const {
+    int slot = findSlot(group_id, probe_length);
+    if (slot >= 0 || unions.getSize() == 0)
+        return slot;
+    int root = unionRoot(group_id);
+    if (root < 0)
+        return -1;
+    int live = unions.find(root)->live;
+    return live < 0 ? -1 : findSlot(live, probe_length);
+}
+
+bool HashTable::addUnionNode(int group_id) {
+    if (unions.find(group_id))
+        return false;
+    UnionNode node;
+    node.parent = group_id;
+    node.rank = 0;
+    node.live = group_id;
+    unions.insert(group_id, node);
+    return true;
+}
+
+int HashTable::findFreeSlot(unsigned int hash, int* probe_length) const {
+    swiss::ProbeSequence sequence(hash, numOfGroups());
+    while (true) {
+        swiss::BitMask free = swiss::ProbeGroup(
+                ctrl + sequence.offset()).matchEmptyOrDeleted();
+        if (free.any()) {
+            *probe_length = sequence.index();
+            return sequence.offset() + free.next();
+        }
+        sequence.next();
+    }
+}
+
+void HashTable::set(int slot, Group* group, unsigned int hash,
+                    int probe_length) {
+    slots[slot] = group;
+    ctrl[slot] = swiss::h2(hash);
+    countProbe(probe_length, 1);
+}
+
+void HashTable::countProbe(int probe_length, int delta) {
+    if (probe_length >= HASH_TABLE_PROBE_HISTOGRAM)
+        probe_length = HASH_TABLE_PROBE_HISTOGRAM - 1;
+    probe_histogram[probe_length] += delta;
+}
+
+void HashTable::recountProbes() {
+    for (int i = 0; i < HASH_TABLE_PROBE_HISTOGRAM; i++)
+        probe_histogram[i] = 0;
+    for (int i = 0; i < array_size; i++) {
+        if (!swiss::isFull(ctrl[i]))
+            continue;
+        swiss::ProbeSequence sequence(swiss::mix(slots[i]->getID()),
+                                      numOfGroups());
+        while (i / SWISS_GROUP_WIDTH != sequence.offset() / SWISS_GROUP_WIDTH)
+            sequence.next();
+        countProbe(sequence.index(), 1);
+    }
+}
+
+Group& HashTable::find(int group_id) {
+    int slot = findSlot(group_id);
+    if (slot < 0 && unions.getSize() > 0) {
+        slot = resolveSlot(group_id);
+        compressPath(group_id);
+    }
+    if (slot < 0)
+        throw KeyNotFound();
+    return *slots[slot];
+}
+
+const Group& HashTable::find(int group_id) const {
+    int slot = resolveSlot(group_id);
+    if (slot < 0)
+        throw KeyNotFound();
+    return *slots[slot];
+}
+
+bool HashTable::contains(int group_id) const {
+    return resolveSlot(group_id) >= 0;
+}
+
+
+Group& HashTable::operator[](int x) {
+    return find(x);
+}
+
+int HashTable::findBatch(const int* group_ids, int n, Group** out) {
+    int found = 0;
+    for (int first = 0; first < n; first += HASH_TABLE_BATCH_SIZE) {
+        int count = n - first < HASH_TABLE_BATCH_SIZE ?
+                    n - first : HASH_TABLE_BATCH_SIZE;
+        unsigned int hash[HASH_TABLE_BATCH_SIZE];
+        int offset[HASH_TABLE_BATCH_SIZE];
+        //stage 1: hash every key and prefetch its first probe group
+        for (int i = 0; i < count; i++) {
+            hash[i] = swiss::mix(group_ids[first + i]);
+            offset[i] = swiss::ProbeSequence(hash[i], numOfGroups()).offset();
+            __builtin_prefetch(ctrl + offset[i]);
+            __builtin_prefetch(slots + offset[i]);
+        }
+        //stage 2: match the tags, settle the clear misses and prefetch the
+        //candidate groups
+        swiss::BitMask candidates[HASH_TABLE_BATCH_SIZE];
+        bool has_empty[HASH_TABLE_BATCH_SIZE];
+        for (int i = 0; i < count; i++) {
+            swiss::ProbeGroup probe(ctrl + offset[i]);
+            candidates[i] = probe.match(swiss::h2(hash[i]));
+            has_empty[i] = probe.matchEmpty().any();
+            out[first + i] = NULL;
+            swiss::BitMask prefetch = candidates[i];
+            while (prefetch.any())
+                __builtin_prefetch(slots[offset[i] + prefetch.next()]);
+        }
+        //stage 3: compare the ids of the candidates, the lines needed are
+        //already on the way. Only a key whose first probe group is full
+        //without a match goes on probing
+        for (int i = 0; i < count; i++) {
+            int group_id = group_ids[first + i];
+            while (candidates[i].any()) {
+                Group* group = slots[offset[i] + candidates[i].next()];
+                if (group->getID() == group_id) {
+                    out[first + i] = group;
+                    break;
+                }
+            }
+            if (out[first + i] == NULL &&
+                (!has_empty[i] || unions.getSize() > 0)) {
+                int slot = resolveSlot(group_id);
+                if (slot >= 0)
+                    out[first + i] = slots[slot];
+            }
+            if (out[first + i] != NULL)
+                found++;
+        }
+    }
+    return found;
+}
+
+
+void HashTable::insert(const Group& group) {
+    if (findSlot(group.getID()) >= 0 || unions.find(group.getID()))
+        throw KeyAlreadyExist();
+    unsigned int hash = swiss::mix(group.getID());
+    int probe_length;
+    int slot = findFreeSlot(hash, &probe_length);
+    if (ctrl[slot] == swiss::EMPTY && growthLeft() == 0) {
+        //mostly tombstones - clean them in place, otherwise grow
+        if (num_of_deleted * 2 >= num_of_items)
+            rehash(array_size);
+        else if (array_size == HASH_TABLE_MAX_SIZE)
+            throw std::bad_alloc();
+        else
+            rehash(array_size * 2);
+        slot = findFreeSlot(hash, &probe_length);
+    }
+    Group* new_group = new Group(group);
+    if (ctrl[slot] == swiss::DELETED)
+        num_of_deleted--;
+    set(slot, new_group, hash, probe_length);
+    num_of_items++;
+}
+
+
+void HashTable::absorb(int group_id, int absorbed_id) {
+    int slot = resolveSlot(group_id);
+    int absorbed_probe_length;
+    int absorbed_slot = resolveSlot(absorbed_id, &absorbed_probe_length);
+    if (slot < 0 || absorbed_slot < 0)
+        throw KeyNotFound();
+    if (slot == absorbed_slot)
+        return;
+    Group* group = slots[slot];
+    Group* absorbed = slots[absorbed_slot];
+    int live = group->getID();
+    int dead = absorbed->getID();
+    //the union nodes are the only allocations, they come first and are
+    //taken back if anything fails, so a failure leaves the table as it was
+    bool added_live = addUnionNode(live);
+    bool added_dead = false;
+    try {
+        added_dead = addUnionNode(dead);
+        group->absorb(*absorbed);
+    } catch (...) {
+        if (added_live)
+            unions.remove(live);
+        if (added_dead)
+            unions.remove(dead);
+        throw;
+    }
+
+    //union by rank, the set resolves to the absorbing group
+    compressPath(live);
+    compressPath(dead);
+    int root = unionRoot(live);
+    int other = unionRoot(dead);
+    UnionNode* root_node = unions.find(root);
+    UnionNode* other_node = unions.find(other);
+    if (root_node->rank < other_node->rank) {
+        UnionNode* swapped = root_node;
+        root_node = other_node;
+        other_node = swapped;
+        root = other;
+    }
+    other_node->parent = root;
+    if (root_node->rank == other_node->rank)
+        root_node->rank++;
+    root_node->live = live;
+
+    removeSlot(absorbed_slot, absorbed_probe_length);
+}
+
+void HashTable::remove(int group_id) {
+    int probe_length;
+    int slot = resolveSlot(group_id, &probe_length);
+    if (slot < 0)
+        throw KeyNotFound();
+    int root = unionRoot(slots[slot]->getID());
+    if (root >= 0)
+        unions.find(root)->live = -1; //its ids are retired
+    removeSlot(slot, probe_length);
+}
+
+void HashTable::removeSlot(int slot, int probe_length) {
+    delete slots[slot];
+    countProbe(probe_length, -1);
+    int group_start = slot - slot % SWISS_GROUP_WIDTH;
+    if (swiss::ProbeGroup(ctrl + group_start).matchEmpty().any()) {
+        ctrl[slot] = swiss::EMPTY;
+    } else {
+        ctrl[slot] = swiss::DELETED;
+        num_of_deleted++;
+    }
+    num_of_items--;
+    shrinkIfNeeded();
+}
+
+int HashTable::getSize() const {
+    return num_of_items;
+}
+
+int HashTable::getCapacity() const {
+    return array_size;
+}
+
+HashTable::Iterator HashTable::begin() {
+    return Iterator(this, 0);
+}
+
+HashTable::Iterator HashTable::end() {
+    return Iterator(this, array_size);
+}
+
+HashTable::ConstIterator HashTable::begin() const {
+    return ConstIterator(this, 0);
+}
+
+HashTable::ConstIterator HashTable::end() const {
+    return ConstIterator(this, array_size);
+}
+
+HashTable::Stats HashTable::getStats() const {
+    Stats stats;
+    stats.size = num_of_items;
+    stats.capacity = array_size;
+    stats.num_of_deleted = num_of_deleted;
+    stats.load_factor = (double) num_of_items / array_size;
+    stats.max_probe_length = 0;
+    for (int i = 0; i < HASH_TABLE_PROBE_HISTOGRAM; i++) {
+        stats.probe_histogram[i] = probe_histogram[i];
+        if (probe_histogram[i] > 0)
+            stats.max_probe_length = i;
+    }
+    stats.num_of_rehashes = num_of_rehashes;
+    stats.rehash_seconds = (double) rehash_time / 1e9;
+    stats.bytes_used = sizeof(HashTable) +
+                       (size_t) array_size * (sizeof(signed char) +
+                                              sizeof(Group*)) +
+                       (size_t) num_of_items * sizeof(Group);
+    return stats;
+}
+
+void HashTable::shrinkIfNeeded() {
+    if (array_size <= HASH_TABLE_MIN_SIZE ||
+        (long long) num_of_items * 32 >= (long long) array_size * 7)
+        return;
+    try {
+        rehash(array_size / 2);
+    } catch (std::bad_alloc&) {
+        //shrinking is only an optimization, keep the current table
+    }
+}
+
+void HashTable::rehash(int new_size) {
+    assert(new_size >= HASH_TABLE_MIN_SIZE);
+    assert(new_size / 8 * 7 > num_of_items);
+    long long start = threadCpuTime();
+    int old_size = array_size;
+    signed char* old_ctrl = ctrl;
+    Group** old_slots = slots;
+    array_size = new_size;
+    try {
+        allocate();
+    } catch (std::bad_alloc&) {
+        array_size = old_size; //recover the old table
+        ctrl = old_ctrl;
+        slots = old_slots;
+        throw;
+    }
+    for (int i = 0; i < old_size; i++) {
+        if (swiss::isFull(old_ctrl[i])) {
+            unsigned int hash = swiss::mix(old_slots[i]->getID());
+            int probe_length;
+            int slot = findFreeSlot(hash, &probe_length);
+            set(slot, old_slots[i], hash, probe_length);
+        }
+    }
+    num_of_deleted = 0;
+    delete[] old_ctrl;
+    delete[] old_slots;
+    num_of_rehashes++;
+    rehash_time += threadCpuTime() - start;
+}
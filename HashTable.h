@@ -5,34 +5,303 @@
 #ifndef DSWET2_HASHTABLE_H
 #define DSWET2_HASHTABLE_H
 
-#include "list.h"
 #include <stddef.h>
+#include <time.h>
 #include <exception>
+#include <iterator>
+#include <new>
 #include "cassert"
 #include "Group.h"
+#include "IntMap.h"
+#include "swissGroup.h"
 
+/**minimal number of slots the table will shrink to */
+#define HASH_TABLE_MIN_SIZE SWISS_GROUP_WIDTH
+
+/**maximal number of slots, the largest power of 2 an int can hold */
+#define HASH_TABLE_MAX_SIZE (1 << 30)
+
+/**minimal number of ids per thread for the parallel bulk construction */
+#define HASH_TABLE_PARALLEL_MIN_ITEMS 65536
+
+/**number of keys findBatch keeps in flight */
+#define HASH_TABLE_BATCH_SIZE 16
+
+/**number of buckets in the probe length histogram */
+#define HASH_TABLE_PROBE_HISTOGRAM 16
+
+/**---------------------------HASH TABLE----------------------------------
+ * Groups indexed by id, in an open addressing table (Swiss-table style).
+ * ctrl holds one control byte per slot (see swissGroup.h), and slots holds
+ * a pointer to the group of every full slot. A lookup matches the 7 bit tag
+ * of the id against a whole probe group of control bytes at once, and only
+ * reads the groups whose tag matched, so most misses are answered by a
+ * single group of control bytes.
+ * The groups are allocated one by one and never move, so a reference to a
+ * group stays valid until the group is removed, even across rehashes.
+ * The table keeps at most 7/8 of its slots used (full or DELETED).
+ * A group absorbed by another (see absorb) leaves the table, but its id is
+ * kept in a union-find over group ids, so it goes on resolving to the group
+ * that absorbed it. */
 class HashTable {
+    /**a group id's node in the union-find. Only ids that took part in an
+     * absorb have one */
+    struct UnionNode {
+        int parent;     //the node's own id at a root
+        int rank;       //bounds the height of the root's tree
+        int live;       //at a root - the id of the group in the table the
+                        //whole set resolves to, -1 once it was removed
+    };
+
     int array_size;
     int num_of_items;
-    List<Group>* hash_table;
+    int num_of_deleted;
+    signed char* ctrl;
+    Group** slots;
+    int probe_histogram[HASH_TABLE_PROBE_HISTOGRAM];
+    int num_of_rehashes;
+    long long rehash_time;         //nanoseconds of the rehashing thread
+    IntMap<UnionNode> unions;      //key - group id
 
+    /**REHASH
+     * moves all the groups to a new table with new_size slots, dropping the
+     * DELETED slots. Only the pointers move, no group is copied.
+     * @param new_size - a power of 2, at least HASH_TABLE_MIN_SIZE */
     void rehash(int new_size);
 
-    int hash(int x) {
-        return x % array_size;
+    /**SHRINK IF NEEDED
+     * the table grows when it runs out of free slots (load 7/8, back to
+     * 7/16), and shrinks when the load falls under 7/32 (back to under 7/16).
+     * The gap between the two thresholds keeps insert/remove churn from
+     * rehashing back and forth. */
+    void shrinkIfNeeded();
+
+    /**FIND SLOT
+     * @param probe_length - if not NULL, set to the number of probe groups
+     *                       passed before the slot was found
+     * @return the slot of group_id, or -1 if it isn't in the table */
+    int findSlot(int group_id, int* probe_length = NULL) const;
+
+    /**UNION-FIND HELPERS
+     * unionRoot - @return the root of group_id's set, or -1 if group_id has
+     *             no union node. Doesn't change the nodes, so it is safe
+     *             under a shared lock
+     * compressPath - points the nodes on group_id's path at their root
+     * resolveSlot - findSlot, falling back to the live group of group_id's
+     *               set when the id itself isn't in the table
+     * addUnionNode - gives group_id a node of its own, if it has none
+     *                @return true if a node was added */
+    int unionRoot(int group_id) const;
+    void compressPath(int group_id);
+    int resolveSlot(int group_id, int* probe_length = NULL) const;
+    bool addUnionNode(int group_id);
+
+    /**FIND FREE SLOT
+     * @param probe_length - set to the number of probe groups passed
+     * @return the first EMPTY or DELETED slot on the probe sequence of hash */
+    int findFreeSlot(unsigned int hash, int* probe_length) const;
+
+    /**REMOVE SLOT
+     * deletes the group in slot and frees the slot (see remove) */
+    void removeSlot(int slot, int probe_length);
+
+    /**SET
+     * puts group in slot, tags the slot with the group's hash and counts
+     * the slot's probe length in the histogram */
+    void set(int slot, Group* group, unsigned int hash, int probe_length);
+
+    /**PROBE HISTOGRAM HELPERS
+     * countProbe - adds delta entries of probe_length to the histogram
+     * recountProbes - rebuilds the histogram from the whole table */
+    void countProbe(int probe_length, int delta);
+    void recountProbes();
+
+    /**GROWTH LEFT
+     * @return how many EMPTY slots may still be used before a rehash */
+    int growthLeft() const {
+        return array_size / 8 * 7 - num_of_items - num_of_deleted;
+    }
+
+    int numOfGroups() const {
+        return array_size / SWISS_GROUP_WIDTH;
     }
 
+    /**CAPACITY FOR
+     * @return the smallest legal size that keeps n groups at load <= 1/2
+     * @exception InvalidSize - n groups don't fit in HASH_TABLE_MAX_SIZE */
+    static int capacityFor(int n);
+
+    /**ALLOCATE
+     * sets ctrl and slots to new empty arrays of array_size slots */
+    void allocate();
+
+    /**CLEAR
+     * deletes all the groups and the arrays */
+    void clear();
+
+    /**BULK CONSTRUCTION HELPERS
+     * placeIds - creates a group for each id and places it in the empty
+     *            table. An id whose probe sequence leaves the probe groups
+     *            [first_group, end_group) is not placed but written to
+     *            deferred instead.
+     *            @return false if an id was already in the table
+     * buildFromIds - places all the ids, splitting the probe groups between
+     *                num_threads threads when there are enough ids
+     *                @return false if an id appears twice */
+    bool placeIds(const int* ids, int count, int first_group, int end_group,
+                  int* deferred, int* num_deferred);
+    bool buildFromIds(const int* id_array, int n, int num_threads);
+
+    /**VISIT
+     * the scan behind forEach, applies function(GroupType&) on the groups
+     * in the slots [first, end)
+     * @exception InvalidSize - the range isn't inside [0, array_size] */
+    template<class GroupType, class Func>
+    void visit(Func& function, int first, int end) const;
+
 public:
-    HashTable(const int* id_array, int n);
+    /**EMPTY CONSTRUCTOR
+     * creates an empty table of HASH_TABLE_MIN_SIZE slots */
+    HashTable();
+    /**CONSTRUCTOR
+     * bulk loads a group for each id. The table is presized for load 1/2,
+     * the ids are validated before any group is created, and each group is
+     * placed directly in its slot. Duplicates are found while placing,
+     * without exceptions.
+     * @param id_array - ids of the groups
+     * @param n - number of ids
+     * @param num_threads - when larger than 1 (C++11 builds only), the probe
+     *                      groups are split between threads by range
+     * @exception InvalidSize - n <= 0, or n > HASH_TABLE_MAX_SIZE / 2
+     * @exception Group::InvalidInput - a negative id
+     * @exception KeyAlreadyExist - an id appears twice */
+    HashTable(const int* id_array, int n, int num_threads = 1);
     ~HashTable();
     HashTable(const HashTable&);
     HashTable& operator=(const HashTable&);
 
+    /**FIND
+     * @return the group with group_id, or the group that absorbed it
+     * @exception KeyNotFound - there is no such group */
     Group& find(int group_id);
+    const Group& find(int group_id) const;
+
+    /**CONTAINS
+     * same as find, but reports a missing group without throwing
+     * @return true if group_id resolves to a group in the table */
+    bool contains(int group_id) const;
     Group& operator[](int x);
+
+    /**FIND BATCH
+     * looks up n groups at once. The keys are resolved HASH_TABLE_BATCH_SIZE
+     * at a time in stages: all the keys are hashed and their control bytes
+     * and slots are prefetched, then the tags are matched and the candidate
+     * groups are prefetched, and only then are the ids of the kept
+     * candidates compared. A key probes further groups only when its first
+     * group is full. The cache misses of the keys overlap instead of running
+     * one after the other.
+     * @param group_ids - the ids to look up
+     * @param n - number of ids
+     * @param out - out[i] is set to the group of group_ids[i], or NULL if
+     *              there is no such group
+     * @return number of ids that were found */
+    int findBatch(const int* group_ids, int n, Group** out);
+
+    /**INSERT
+     * @exception KeyAlreadyExist - group's id resolves to a group, or is the
+     *                              id of an absorbed group (these are never
+     *                              reused) */
     void insert(const Group& group);
-    //TODO ? void remove(int key);
-    List<Group> getList(int i) const; //FOR DEBUGGING
+
+    /**ABSORB
+     * moves the gladiators of the group absorbed_id resolves to into the
+     * group group_id resolves to (see Group::absorb), and removes the
+     * emptied group. From then on absorbed_id, and every id that resolved
+     * to the same group, resolves to group_id's group: the two sets are
+     * united by rank in the union-find, and later lookups through it
+     * compress their path, so resolving an old id takes near O(1).
+     * Ids resolving to the same group are left as they are.
+     * The union-find isn't part of a Snapshot, a thawed table knows only
+     * the live groups.
+     * @exception KeyNotFound - an id doesn't resolve to a group
+     * @exception Group::KeyAlreadyExist - the groups share a gladiator.
+     *                                     Nothing is changed */
+    void absorb(int group_id, int absorbed_id);
+
+    /**REMOVE
+     * removes the group group_id resolves to from the table. The ids
+     * resolving to it stop resolving. The slot becomes
+     * EMPTY if its probe group still has an EMPTY slot (no probe sequence
+     * continues past it), otherwise it becomes a DELETED tombstone that is
+     * dropped on the next rehash. The table shrinks if it became too sparse.
+     * @param group_id
+     * @exception KeyNotFound - group_id doesn't resolve to a group */
+    void remove(int group_id);
+
+    int getSize() const;
+
+    /**GET CAPACITY
+     * @return the number of slots. Slot ranges [first, end) of
+     *         [0, getCapacity()) may be scanned independently, e.g. by
+     *         different threads, with forEach */
+    int getCapacity() const;
+
+    /**---------------------------ITERATION-----------------------------
+     * The groups are visited in place, in slot order, nothing is copied.
+     * A const table only hands out const groups.
+     * Iterators are invalidated by insert and remove (they may rehash), the
+     * groups themselves are not. */
+    template<class GroupType>
+    class SlotIterator;
+    typedef SlotIterator<Group> Iterator;
+    typedef SlotIterator<const Group> ConstIterator;
+
+    Iterator begin();
+    Iterator end();
+    ConstIterator begin() const;
+    ConstIterator end() const;
+
+    /**FOR EACH
+     * applies function(Group&) on every group in the table. On a const
+     * table function gets a const Group& instead.
+     * @tparam Func - function object with one parameter of type Group& */
+    template<class Func>
+    void forEach(Func& function);
+    template<class Func>
+    void forEach(Func& function) const;
+
+    /**FOR EACH
+     * applies function(Group&) on every group in the slots [first, end).
+     * Scans of disjoint ranges may run at the same time.
+     * @exception InvalidSize - the range isn't inside [0, getCapacity()] */
+    template<class Func>
+    void forEach(Func& function, int first, int end);
+    template<class Func>
+    void forEach(Func& function, int first, int end) const;
+
+    /**---------------------------STATS---------------------------------
+     * A snapshot of the table's health. Filling it reads a few counters the
+     * table keeps up to date, it doesn't scan or copy the table, so it is
+     * cheap enough to poll often. */
+    struct Stats {
+        int size;
+        int capacity;
+        int num_of_deleted;
+        double load_factor;             //size / capacity
+        /**probe_histogram[i] - groups found at their i-th probe group. The
+         * last bucket also counts the longer probes */
+        int probe_histogram[HASH_TABLE_PROBE_HISTOGRAM];
+        int max_probe_length;           //last non empty histogram bucket
+        int num_of_rehashes;            //grows, shrinks and compactions
+        double rehash_seconds;          //cpu time spent rehashing, of the
+                                        //rehashing thread only
+        size_t bytes_used;              //table arrays and Group objects,
+                                        //not including the groups' trees
+    };
+
+    /**GET STATS
+     * @return the current stats of the table */
+    Stats getStats() const;
 
     class HashTableException : public std::exception {
     };
@@ -46,128 +315,109 @@ public:
     class InvalidSize : public HashTableException {
 
     };
+};
 
-    class Compare {
-        int id;
-    public:
-        explicit Compare(int id) : id(id) {}
+/**forward iterator over the groups of the table
+ * @tparam GroupType - Group, or const Group for a const table */
+template<class GroupType>
+class HashTable::SlotIterator {
+    const HashTable* table;
+    int slot;
 
-        bool operator()(const Group& group) const {
-            return group.getID() == id;
-        }
-    };
-};
+    SlotIterator(const HashTable* table, int slot) : table(table), slot(slot) {
+        skipFree();
+    }
 
-HashTable::HashTable(const int* id_array, int n) : array_size(n * 2),
-                                                   num_of_items(0),
-                                                   hash_table(NULL) {
-    if (n <= 0)
-        throw InvalidSize();
-    hash_table = new List<Group>[n * 2];
-    try {
-        for (int i = 0; i < n; i++) {
-            assert(num_of_items < array_size);
-            insert(Group(id_array[i]));
-        }
-        assert(num_of_items == n);
-    } catch (std::bad_alloc& e) {
-        delete[] hash_table;
-        throw e;
-    } catch (Group::InvalidInput& e) {
-        delete[] hash_table;
-        throw e;
+    /**moves forward to the next full slot (or to the end) */
+    void skipFree() {
+        while (slot < table->array_size && !swiss::isFull(table->ctrl[slot]))
+            slot++;
     }
-}
 
-HashTable::~HashTable() {
-    delete[] hash_table;
-}
+    friend class HashTable;
+    template<class> friend class SlotIterator;
 
-HashTable::HashTable(const HashTable& source) :
-        array_size(source.array_size), num_of_items(source.num_of_items),
-        hash_table(NULL) {
-    hash_table = new List<Group>[source.array_size];
-    try {
-        for (int i = 0; i < array_size; i++) {
-            hash_table[i] = source.hash_table[i];
-        }
-    } catch (std::bad_alloc& e) {
-        delete[] hash_table;
-        throw e;
-    }
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Group value_type;
+    typedef ptrdiff_t difference_type;
+    typedef GroupType* pointer;
+    typedef GroupType& reference;
 
-}
+    /**an Iterator converts to a ConstIterator */
+    SlotIterator(const SlotIterator<Group>& iterator) :
+            table(iterator.table), slot(iterator.slot) {}
 
-HashTable& HashTable::operator=(const HashTable& source) {
-    List<Group>* temp_copy = new List<Group>[source.array_size];
-    try {
-        for (int i = 0; i < source.array_size; i++) {
-            temp_copy[i] = source.hash_table[i];
-        }
-    } catch (std::bad_alloc& e) {
-        delete[] temp_copy;
-        throw e;
+    GroupType& operator*() const {
+        assert(slot < table->array_size);
+        return *table->slots[slot];
     }
-    delete[] this->hash_table;
-    this->hash_table = temp_copy;
-    this->array_size = source.array_size;
-    this->num_of_items = source.num_of_items;
-    return *this;
-}
 
-Group& HashTable::find(int group_id) {
-    Compare compare(group_id);
-    typename List<Group>::Iterator iterator = hash_table[hash(group_id)].find(compare);
-    if (iterator == hash_table[hash(group_id)].end())
-        throw KeyNotFound();
-    return *iterator;
-}
+    GroupType* operator->() const {
+        return &**this;
+    }
 
+    SlotIterator& operator++() {
+        slot++;
+        skipFree();
+        return *this;
+    }
 
-Group& HashTable::operator[](int x) {
-    return find(x);
-}
+    SlotIterator operator++(int) {
+        SlotIterator result = *this;
+        ++*this;
+        return result;
+    }
 
+    bool operator==(const SlotIterator& iterator) const {
+        return table == iterator.table && slot == iterator.slot;
+    }
 
-void HashTable::insert(const Group& group) {
-    try { //check if group already exist
-        find(group.getID());
-    } catch (KeyNotFound& e) {
-        if (num_of_items == array_size) { //reallocate
-            rehash(array_size * 2);
-        }
-        hash_table[hash(group.getID())].insert(group);
-        num_of_items++;
-        return;
+    bool operator!=(const SlotIterator& iterator) const {
+        return !(*this == iterator);
+    }
+};
+
+template<class GroupType, class Func>
+void HashTable::visit(Func& function, int first, int end) const {
+    if (first < 0 || end > array_size || first > end)
+        throw InvalidSize();
+    int slot = first;
+    //the unaligned head and tail one slot at a time, whole probe groups
+    //in between are matched at once
+    for (; slot < end && slot % SWISS_GROUP_WIDTH != 0; slot++) {
+        if (swiss::isFull(ctrl[slot]))
+            function(static_cast<GroupType&>(*slots[slot]));
+    }
+    for (; slot + SWISS_GROUP_WIDTH <= end; slot += SWISS_GROUP_WIDTH) {
+        swiss::BitMask full = swiss::ProbeGroup(ctrl + slot).matchFull();
+        while (full.any())
+            function(static_cast<GroupType&>(*slots[slot + full.next()]));
+    }
+    for (; slot < end; slot++) {
+        if (swiss::isFull(ctrl[slot]))
+            function(static_cast<GroupType&>(*slots[slot]));
     }
-    throw KeyAlreadyExist();
 }
 
+template<class Func>
+void HashTable::forEach(Func& function) {
+    visit<Group>(function, 0, array_size);
+}
 
-void HashTable::rehash(int new_size) {
-    assert(new_size > 0);
-    List<Group>* temp_copy = new List<Group>[new_size];
-    int old_size = this->array_size;
-    try {
-        this->array_size = new_size;
-        for (int i = 0; i < old_size; i++) {
-            for (typename List<Group>::Iterator iterator = hash_table[i].begin();
-                 iterator != hash_table[i].end(); iterator++) {
-                Group& current = *iterator;
-                temp_copy[hash(current.getID())].insert(current);
-            }
-        }
-    } catch (std::bad_alloc& e) {
-        this->array_size = old_size; //recover size
-        delete[] temp_copy;
-        throw e;
-    }
-    delete[] this->hash_table;
-    this->hash_table = temp_copy;
+template<class Func>
+void HashTable::forEach(Func& function) const {
+    visit<const Group>(function, 0, array_size);
+}
+
+template<class Func>
+void HashTable::forEach(Func& function, int first, int end) {
+    visit<Group>(function, first, end);
 }
 
-List<Group> HashTable::getList(int i) const {
-    return hash_table[i];
+template<class Func>
+void HashTable::forEach(Func& function, int first, int end) const {
+    visit<const Group>(function, first, end);
 }
 
 #endif //DSWET2_HASHTABLE_H
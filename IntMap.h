@@ -0,0 +1,299 @@
+
+#ifndef DSWET2_INTMAP_H
+#define DSWET2_INTMAP_H
+
+#include <exception>
+#include <new>
+#include <string.h>
+#include <cassert>
+#include "swissGroup.h"
+
+/**minimal number of slots the map will shrink to */
+#define INT_MAP_MIN_SIZE SWISS_GROUP_WIDTH
+
+/**maximal number of slots */
+#define INT_MAP_MAX_SIZE (1 << 30)
+
+/**---------------------------INT MAP----------------------------------
+ * A map from int keys to small values, in the layout of HashTable (control
+ * bytes matched a probe group at a time, see swissGroup.h), but with the
+ * keys and the values stored flat in arrays parallel to the control bytes
+ * instead of behind pointers. A lookup reads the control bytes, the keys of
+ * the matched slots, and then the one value it returns.
+ * Values move when the map rehashes, so a pointer returned by find is
+ * valid until the next insert or remove.
+ * The load policy is HashTable's: at most 7/8 of the slots used (full or
+ * DELETED), shrinking when less than 7/32 are full.
+ * @tparam Value - default constructible and assignable */
+template<class Value>
+class IntMap {
+    int array_size;
+    int num_of_items;
+    int num_of_deleted;
+    signed char* ctrl;
+    int* keys;
+    Value* values;
+
+    /**@return the slot of key, or -1 if it isn't in the map */
+    int findSlot(int key) const;
+
+    /**@return the first EMPTY or DELETED slot on the probe sequence of hash */
+    int findFreeSlot(unsigned int hash) const;
+
+    /**sets ctrl, keys and values to new empty arrays of array_size slots */
+    void allocate();
+
+    /**deletes the arrays */
+    void clear();
+
+    /**moves the entries to new arrays of new_size slots, dropping the
+     * DELETED slots */
+    void rehash(int new_size);
+
+    int growthLeft() const {
+        return array_size / 8 * 7 - num_of_items - num_of_deleted;
+    }
+
+    int numOfGroups() const {
+        return array_size / SWISS_GROUP_WIDTH;
+    }
+
+public:
+    /**EMPTY CONSTRUCTOR
+     * creates an empty map of INT_MAP_MIN_SIZE slots */
+    IntMap();
+    IntMap(const IntMap& map);
+    ~IntMap();
+    IntMap& operator=(const IntMap& map);
+
+    /**FIND
+     * @return a pointer to the value of key, or NULL if key isn't in the
+     *         map. Valid until the next insert or remove */
+    Value* find(int key);
+    const Value* find(int key) const;
+
+    /**INSERT
+     * @exception KeyAlreadyExist - key is already in the map */
+    void insert(int key, const Value& value);
+
+    /**REMOVE
+     * @exception KeyNotFound - key isn't in the map */
+    void remove(int key);
+
+    int getSize() const;
+
+    class IntMapException : public std::exception {
+    };
+
+    class KeyNotFound : public IntMapException {
+    };
+
+    class KeyAlreadyExist : public IntMapException {
+    };
+};
+
+template<class Value>
+IntMap<Value>::IntMap() : array_size(INT_MAP_MIN_SIZE), num_of_items(0),
+                          num_of_deleted(0), ctrl(NULL), keys(NULL),
+                          values(NULL) {
+    allocate();
+}
+
+template<class Value>
+IntMap<Value>::IntMap(const IntMap& map) :
+        array_size(map.array_size), num_of_items(map.num_of_items),
+        num_of_deleted(map.num_of_deleted), ctrl(NULL), keys(NULL),
+        values(NULL) {
+    allocate();
+    memcpy(ctrl, map.ctrl, array_size);
+    for (int i = 0; i < array_size; i++) {
+        if (swiss::isFull(ctrl[i])) {
+            keys[i] = map.keys[i];
+            values[i] = map.values[i];
+        }
+    }
+}
+
+template<class Value>
+IntMap<Value>::~IntMap() {
+    clear();
+}
+
+template<class Value>
+IntMap<Value>& IntMap<Value>::operator=(const IntMap& map) {
+    if (this == &map)
+        return *this;
+    IntMap copy(map);
+    //take over the copy's arrays and leave it ours to delete
+    int saved_size = array_size;
+    signed char* saved_ctrl = ctrl;
+    int* saved_keys = keys;
+    Value* saved_values = values;
+    array_size = copy.array_size;
+    num_of_items = copy.num_of_items;
+    num_of_deleted = copy.num_of_deleted;
+    ctrl = copy.ctrl;
+    keys = copy.keys;
+    values = copy.values;
+    copy.array_size = saved_size;
+    copy.ctrl = saved_ctrl;
+    copy.keys = saved_keys;
+    copy.values = saved_values;
+    return *this;
+}
+
+template<class Value>
+void IntMap<Value>::allocate() {
+    signed char* new_ctrl = new signed char[array_size];
+    int* new_keys = NULL;
+    try {
+        new_keys = new int[array_size];
+        values = new Value[array_size];
+    } catch (std::bad_alloc&) {
+        delete[] new_ctrl;
+        delete[] new_keys;
+        throw;
+    }
+    ctrl = new_ctrl;
+    keys = new_keys;
+    memset(ctrl, swiss::EMPTY, array_size);
+}
+
+template<class Value>
+void IntMap<Value>::clear() {
+    delete[] ctrl;
+    delete[] keys;
+    delete[] values;
+    ctrl = NULL;
+    keys = NULL;
+    values = NULL;
+}
+
+template<class Value>
+int IntMap<Value>::findSlot(int key) const {
+    unsigned int hash = swiss::mix(key);
+    swiss::ProbeSequence sequence(hash, numOfGroups());
+    while (true) {
+        swiss::ProbeGroup probe(ctrl + sequence.offset());
+        swiss::BitMask candidates = probe.match(swiss::h2(hash));
+        while (candidates.any()) {
+            int slot = sequence.offset() + candidates.next();
+            if (keys[slot] == key)
+                return slot;
+        }
+        if (probe.matchEmpty().any())
+            return -1;
+        sequence.next();
+    }
+}
+
+template<class Value>
+int IntMap<Value>::findFreeSlot(unsigned int hash) const {
+    swiss::ProbeSequence sequence(hash, numOfGroups());
+    while (true) {
+        swiss::BitMask free = swiss::ProbeGroup(
+                ctrl + sequence.offset()).matchEmptyOrDeleted();
+        if (free.any())
+            return sequence.offset() + free.next();
+        sequence.next();
+    }
+}
+
+template<class Value>
+Value* IntMap<Value>::find(int key) {
+    int slot = findSlot(key);
+    return slot < 0 ? NULL : &values[slot];
+}
+
+template<class Value>
+const Value* IntMap<Value>::find(int key) const {
+    int slot = findSlot(key);
+    return slot < 0 ? NULL : &values[slot];
+}
+
+template<class Value>
+void IntMap<Value>::insert(int key, const Value& value) {
+    if (findSlot(key) >= 0)
+        throw KeyAlreadyExist();
+    unsigned int hash = swiss::mix(key);
+    int slot = findFreeSlot(hash);
+    if (ctrl[slot] == swiss::EMPTY && growthLeft() == 0) {
+        //mostly tombstones - clean them in place, otherwise grow
+        if (num_of_deleted * 2 >= num_of_items)
+            rehash(array_size);
+        else if (array_size == INT_MAP_MAX_SIZE)
+            throw std::bad_alloc();
+        else
+            rehash(array_size * 2);
+        slot = findFreeSlot(hash);
+    }
+    if (ctrl[slot] == swiss::DELETED)
+        num_of_deleted--;
+    keys[slot] = key;
+    values[slot] = value;
+    ctrl[slot] = swiss::h2(hash);
+    num_of_items++;
+}
+
+template<class Value>
+void IntMap<Value>::remove(int key) {
+    int slot = findSlot(key);
+    if (slot < 0)
+        throw KeyNotFound();
+    int group_start = slot - slot % SWISS_GROUP_WIDTH;
+    if (swiss::ProbeGroup(ctrl + group_start).matchEmpty().any()) {
+        ctrl[slot] = swiss::EMPTY;
+    } else {
+        ctrl[slot] = swiss::DELETED;
+        num_of_deleted++;
+    }
+    num_of_items--;
+    if (array_size > INT_MAP_MIN_SIZE &&
+        (long long) num_of_items * 32 < (long long) array_size * 7) {
+        try {
+            rehash(array_size / 2);
+        } catch (std::bad_alloc&) {
+            //shrinking is only an optimization, keep the current arrays
+        }
+    }
+}
+
+template<class Value>
+int IntMap<Value>::getSize() const {
+    return num_of_items;
+}
+
+template<class Value>
+void IntMap<Value>::rehash(int new_size) {
+    assert(new_size >= INT_MAP_MIN_SIZE);
+    assert(new_size / 8 * 7 > num_of_items);
+    int old_size = array_size;
+    signed char* old_ctrl = ctrl;
+    int* old_keys = keys;
+    Value* old_values = values;
+    array_size = new_size;
+    try {
+        allocate();
+    } catch (std::bad_alloc&) {
+        array_size = old_size; //recover the old arrays
+        ctrl = old_ctrl;
+        keys = old_keys;
+        values = old_values;
+        throw;
+    }
+    for (int i = 0; i < old_size; i++) {
+        if (swiss::isFull(old_ctrl[i])) {
+            unsigned int hash = swiss::mix(old_keys[i]);
+            int slot = findFreeSlot(hash);
+            keys[slot] = old_keys[i];
+            values[slot] = old_values[i];
+            ctrl[slot] = swiss::h2(hash);
+        }
+    }
+    num_of_deleted = 0;
+    delete[] old_ctrl;
+    delete[] old_keys;
+    delete[] old_values;
+}
+
+#endif //DSWET2_INTMAP_H
@@ -0,0 +1,58 @@
+
+#include "Leaderboard.h"
+
+typedef Splay<int, ScoreKey> ScoreTree;
+
+void Leaderboard::add(int gladiator_id, int score) {
+    try {
+        tree.insert(gladiator_id, ScoreKey(score, gladiator_id), score);
+    } catch (ScoreTree::KeyAlreadyExist&) {
+        throw KeyAlreadyExist();
+    }
+}
+
+void Leaderboard::remove(int gladiator_id, int score) {
+    try {
+        tree.remove(ScoreKey(score, gladiator_id));
+    } catch (ScoreTree::KeyNotFound&) {
+        throw KeyNotFound();
+    }
+}
+
+void Leaderboard::update(int gladiator_id, int old_score, int new_score) {
+    if (old_score == new_score) {
+        rank(gladiator_id, old_score); //only checks it is there
+        return;
+    }
+    try {
+        tree.find(ScoreKey(old_score, gladiator_id));
+    } catch (ScoreTree::KeyNotFound&) {
+        throw KeyNotFound();
+    }
+    tree.insert(gladiator_id, ScoreKey(new_score, gladiator_id), new_score);
+    tree.remove(ScoreKey(old_score, gladiator_id));
+}
+
+int Leaderboard::select(int k) {
+    if (k < 1 || k > tree.getSize())
+        throw InvalidInput();
+    return tree.select(k).getId();
+}
+
+int Leaderboard::rank(int gladiator_id, int score) {
+    try {
+        return tree.rank(ScoreKey(score, gladiator_id));
+    } catch (ScoreTree::KeyNotFound&) {
+        throw KeyNotFound();
+    }
+}
+
+long long Leaderboard::topKWeight(int k) {
+    if (k < 0 || k > tree.getSize())
+        throw InvalidInput();
+    return tree.prefixWeight(k);
+}
+
+int Leaderboard::getSize() const {
+    return tree.getSize();
+}
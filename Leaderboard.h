@@ -0,0 +1,66 @@
+
+#ifndef DSWET2_LEADERBOARD_H
+#define DSWET2_LEADERBOARD_H
+
+#include "splayTree.h"
+#include "ScoreKey.h"
+#include <exception>
+
+using namespace trees;
+
+/**---------------------------LEADERBOARD----------------------------------
+ * All the gladiators of all the groups in one order statistics tree, by
+ * (score desc, id asc), with the score as the node value. Position k is
+ * answered by the subtree sizes and the top-k score sum by the subtree
+ * weights, each in a single descent of the splay tree, amortized O(log N)
+ * for N gladiators. It is updated one gladiator at a time, never rebuilt.
+ * Positions are 1 based, 1 is the best gladiator. */
+class Leaderboard {
+    Splay<int, ScoreKey> tree; //data - gladiator id, value - score
+
+public:
+    /**ADD
+     * @exception KeyAlreadyExist - the gladiator is already in */
+    void add(int gladiator_id, int score);
+
+    /**REMOVE
+     * @exception KeyNotFound - no gladiator with this id and score */
+    void remove(int gladiator_id, int score);
+
+    /**UPDATE
+     * moves the gladiator from old_score to new_score. The only allocation
+     * comes first, so a failure leaves the leaderboard as it was
+     * @exception KeyNotFound - no gladiator with this id and old_score */
+    void update(int gladiator_id, int old_score, int new_score);
+
+    /**SELECT
+     * @return the id of the gladiator at position k
+     * @exception InvalidInput - k isn't in [1, size] */
+    int select(int k);
+
+    /**RANK
+     * @return the position of the gladiator with this id and score
+     * @exception KeyNotFound - no gladiator with this id and score */
+    int rank(int gladiator_id, int score);
+
+    /**TOP K WEIGHT
+     * @return the sum of the scores at positions 1..k
+     * @exception InvalidInput - k isn't in [0, size] */
+    long long topKWeight(int k);
+
+    int getSize() const;
+
+    class LeaderboardException : public std::exception {
+    };
+
+    class InvalidInput : public LeaderboardException {
+    };
+
+    class KeyNotFound : public LeaderboardException {
+    };
+
+    class KeyAlreadyExist : public LeaderboardException {
+    };
+};
+
+#endif //DSWET2_LEADERBOARD_H
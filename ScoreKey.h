@@ -0,0 +1,52 @@
+
+#ifndef DSWET2_SCOREKEY_H
+#define DSWET2_SCOREKEY_H
+
+#include <stdint.h>
+
+#define SCORE_KEY_SIGN 0x80000000u
+
+/**---------------------------SCORE KEY----------------------------------
+ * a gladiator's place in a score order: higher scores first, equal scores
+ * by increasing id. Both are packed in one 64 bit integer whose unsigned
+ * order is the score order, so a tree compares two keys with one integer
+ * compare (see ThreeWayCompare): the high half holds the complemented score,
+ * the low half the id, each with its sign bit flipped. */
+class ScoreKey {
+    uint64_t packed;
+
+    static uint64_t pack(int score, int id) {
+        uint32_t descending_score = ~((uint32_t) score ^ SCORE_KEY_SIGN);
+        uint32_t ascending_id = (uint32_t) id ^ SCORE_KEY_SIGN;
+        return ((uint64_t) descending_score << 32) | ascending_id;
+    }
+
+public:
+    /**EMPTY CONSTRUCTOR
+     * the key of score 0 and id 0 */
+    ScoreKey() : packed(pack(0, 0)) {}
+
+    ScoreKey(int score, int id) : packed(pack(score, id)) {}
+
+    int getScore() const {
+        return (int) (~(uint32_t) (packed >> 32) ^ SCORE_KEY_SIGN);
+    }
+
+    int getId() const {
+        return (int) ((uint32_t) packed ^ SCORE_KEY_SIGN);
+    }
+
+    bool operator<(const ScoreKey& key) const {
+        return packed < key.packed;
+    }
+
+    bool operator>(const ScoreKey& key) const {
+        return packed > key.packed;
+    }
+
+    bool operator==(const ScoreKey& key) const {
+        return packed == key.packed;
+    }
+};
+
+#endif //DSWET2_SCOREKEY_H
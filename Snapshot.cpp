@@ -0,0 +1,340 @@
+#include "Snapshot.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char SNAPSHOT_MAGIC[8] = "DSWSNAP";
+
+/**output buffer size of the snapshot writer */
+#define SNAPSHOT_BUFFER_SIZE (1 << 16)
+
+/**---------------------------WRITER HELPERS-------------------------------*/
+namespace {
+
+    /**writes to a file through a fixed size buffer
+     * @exception Snapshot::IOError on any failed write */
+    class BufferedWriter {
+        FILE* file;
+        char buffer[SNAPSHOT_BUFFER_SIZE];
+        size_t used;
+
+    public:
+        explicit BufferedWriter(FILE* file) : file(file), used(0) {}
+
+        void write(const void* source, size_t size) {
+            if (used + size > SNAPSHOT_BUFFER_SIZE)
+                flush();
+            if (size > SNAPSHOT_BUFFER_SIZE) {
+                if (fwrite(source, 1, size, file) != size)
+                    throw Snapshot::IOError();
+                return;
+            }
+            memcpy(buffer + used, source, size);
+            used += size;
+        }
+
+        void flush() {
+            if (used > 0 && fwrite(buffer, 1, used, file) != used)
+                throw Snapshot::IOError();
+            used = 0;
+        }
+    };
+
+    class CollectGroups {
+    public:
+        const Group** groups;
+        int count;
+        long long num_of_gladiators;
+
+        explicit CollectGroups(const Group** groups) :
+                groups(groups), count(0), num_of_gladiators(0) {}
+
+        void operator()(const Group& group) {
+            groups[count++] = &group;
+            num_of_gladiators += group.getNumOfGladiators();
+        }
+    };
+
+    bool compareIDs(const Group* first, const Group* second) {
+        return first->getID() < second->getID();
+    }
+
+    /**writes the records of one group, gladiators arrive by increasing id */
+    class WriteRecords {
+        BufferedWriter& writer;
+        long long prefix_score;
+
+    public:
+        explicit WriteRecords(BufferedWriter& writer) : writer(writer),
+                                                        prefix_score(0) {}
+
+        void operator()(const Gladiator& gladiator) {
+            prefix_score += gladiator.getScore();
+            Snapshot::GladiatorRecord record;
+            record.id = gladiator.getId();
+            record.score = gladiator.getScore();
+            record.prefix_score = prefix_score;
+            writer.write(&record, sizeof(record));
+        }
+    };
+}
+
+void Snapshot::write(const HashTable& table, const char* path) {
+    //the last good snapshot is only replaced, by rename(), once the new one
+    //is complete on disk
+    std::string temp_path = std::string(path) + ".tmp";
+    const Group** groups =
+            new const Group* [table.getSize() > 0 ? table.getSize() : 1];
+    FILE* file = NULL;
+    BufferedWriter* writer = NULL;
+    try {
+        CollectGroups collect(groups);
+        table.forEach(collect);
+        std::sort(groups, groups + collect.count, compareIDs);
+
+        file = fopen(temp_path.c_str(), "wb");
+        if (file == NULL)
+            throw IOError();
+        writer = new BufferedWriter(file);
+
+        Header header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.version = VERSION;
+        header.byte_order = BYTE_ORDER_MARK;
+        header.num_of_groups = collect.count;
+        header.num_of_gladiators = collect.num_of_gladiators;
+        header.groups_offset = sizeof(Header);
+        header.gladiators_offset =
+                sizeof(Header) + (int64_t) collect.count * sizeof(GroupEntry);
+        writer->write(&header, sizeof(header));
+
+        int64_t first_gladiator = 0;
+        for (int i = 0; i < collect.count; i++) {
+            GroupEntry entry;
+            memset(&entry, 0, sizeof(entry));
+            entry.id = groups[i]->getID();
+            entry.num_of_gladiators = groups[i]->getNumOfGladiators();
+            entry.first_gladiator = first_gladiator;
+            first_gladiator += entry.num_of_gladiators;
+            writer->write(&entry, sizeof(entry));
+        }
+        for (int i = 0; i < collect.count; i++) {
+            WriteRecords write_records(*writer);
+            groups[i]->forEachGladiator(write_records);
+        }
+        writer->flush();
+        if (fflush(file) != 0 || fsync(fileno(file)) != 0)
+            throw IOError();
+        int failed = fclose(file);
+        file = NULL;
+        if (failed || rename(temp_path.c_str(), path) != 0)
+            throw IOError();
+    } catch (...) {
+        if (file)
+            fclose(file);
+        unlink(temp_path.c_str()); //the old snapshot at path is untouched
+        delete writer;
+        delete[] groups;
+        throw;
+    }
+    delete writer;
+    delete[] groups;
+}
+
+/**---------------------------FROZEN SNAPSHOT------------------------------*/
+
+FrozenSnapshot::FrozenSnapshot(const char* path) : data(NULL), length(0),
+                                                   header(NULL), groups(NULL),
+                                                   gladiators(NULL) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        throw Snapshot::IOError();
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        ::close(fd);
+        throw Snapshot::IOError();
+    }
+    length = (size_t) status.st_size;
+    if (length < sizeof(Snapshot::Header)) {
+        ::close(fd);
+        throw Snapshot::InvalidFormat();
+    }
+    void* mapped = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); //the mapping keeps the file alive
+    if (mapped == MAP_FAILED)
+        throw Snapshot::IOError();
+    data = (const char*) mapped;
+    header = (const Snapshot::Header*) data;
+    try {
+        validate();
+    } catch (Snapshot::InvalidFormat&) {
+        munmap((void*) data, length);
+        throw;
+    }
+    groups = (const Snapshot::GroupEntry*) (data + header->groups_offset);
+    gladiators = (const Snapshot::GladiatorRecord*)
+            (data + header->gladiators_offset);
+}
+
+FrozenSnapshot::~FrozenSnapshot() {
+    munmap((void*) data, length);
+}
+
+void FrozenSnapshot::validate() const {
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != Snapshot::VERSION ||
+        header->byte_order != Snapshot::BYTE_ORDER_MARK ||
+        header->num_of_groups < 0 || header->num_of_gladiators < 0)
+        throw Snapshot::InvalidFormat();
+    //the offsets and counts are untrusted, each is bounded by the length
+    //before it is used in any arithmetic
+    const uint64_t size = length;
+    const uint64_t groups_offset = (uint64_t) header->groups_offset;
+    const uint64_t gladiators_offset = (uint64_t) header->gladiators_offset;
+    if (header->groups_offset < (int64_t) sizeof(Snapshot::Header) ||
+        groups_offset > size || groups_offset % 8 != 0 ||
+        (uint64_t) header->num_of_groups >
+        (size - groups_offset) / sizeof(Snapshot::GroupEntry))
+        throw Snapshot::InvalidFormat();
+    const uint64_t groups_end = groups_offset +
+            (uint64_t) header->num_of_groups * sizeof(Snapshot::GroupEntry);
+    if (header->gladiators_offset < 0 || gladiators_offset < groups_end ||
+        gladiators_offset > size || gladiators_offset % 8 != 0 ||
+        (uint64_t) header->num_of_gladiators >
+        (size - gladiators_offset) / sizeof(Snapshot::GladiatorRecord))
+        throw Snapshot::InvalidFormat();
+
+    const Snapshot::GroupEntry* entries =
+            (const Snapshot::GroupEntry*) (data + groups_offset);
+    const Snapshot::GladiatorRecord* records =
+            (const Snapshot::GladiatorRecord*) (data + gladiators_offset);
+    int64_t expected_first = 0;
+    for (int i = 0; i < header->num_of_groups; i++) {
+        if ((i > 0 && entries[i - 1].id >= entries[i].id) ||
+            entries[i].id < 0 || entries[i].num_of_gladiators < 0 ||
+            entries[i].first_gladiator != expected_first ||
+            entries[i].num_of_gladiators >
+            header->num_of_gladiators - expected_first)
+            throw Snapshot::InvalidFormat();
+        //the lookups binary search the records, and thaw builds the tree
+        //from them, so they must be sorted and their prefix sums right
+        const Snapshot::GladiatorRecord* group = records + expected_first;
+        int64_t prefix_score = 0;
+        for (int j = 0; j < entries[i].num_of_gladiators; j++) {
+            prefix_score += group[j].score;
+            if ((j > 0 && group[j - 1].id >= group[j].id) ||
+                group[j].prefix_score != prefix_score)
+                throw Snapshot::InvalidFormat();
+        }
+        expected_first += entries[i].num_of_gladiators;
+    }
+    if (expected_first != header->num_of_gladiators)
+        throw Snapshot::InvalidFormat();
+}
+
+const Snapshot::GroupEntry& FrozenSnapshot::findGroup(int group_id) const {
+    int low = 0;
+    int high = header->num_of_groups;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (groups[middle].id < group_id)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    if (low == header->num_of_groups || groups[low].id != group_id)
+        throw KeyNotFound();
+    return groups[low];
+}
+
+const Snapshot::GladiatorRecord&
+FrozenSnapshot::findGladiator(const Snapshot::GroupEntry& group,
+                              int gladiator_id) const {
+    const Snapshot::GladiatorRecord* first =
+            gladiators + group.first_gladiator;
+    int low = 0;
+    int high = group.num_of_gladiators;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (first[middle].id < gladiator_id)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    if (low == group.num_of_gladiators || first[low].id != gladiator_id)
+        throw KeyNotFound();
+    return first[low];
+}
+
+int FrozenSnapshot::getNumOfGroups() const {
+    return header->num_of_groups;
+}
+
+bool FrozenSnapshot::containsGroup(int group_id) const {
+    try {
+        findGroup(group_id);
+    } catch (KeyNotFound&) {
+        return false;
+    }
+    return true;
+}
+
+int FrozenSnapshot::getNumOfGladiators(int group_id) const {
+    return findGroup(group_id).num_of_gladiators;
+}
+
+int FrozenSnapshot::getScore(int group_id, int gladiator_id) const {
+    return findGladiator(findGroup(group_id), gladiator_id).score;
+}
+
+long long FrozenSnapshot::rankWeight(int group_id, int gladiator_id) const {
+    return findGladiator(findGroup(group_id), gladiator_id).prefix_score;
+}
+
+int FrozenSnapshot::select(int group_id, int k) const {
+    const Snapshot::GroupEntry& group = findGroup(group_id);
+    if (k <= 0 || k > group.num_of_gladiators)
+        throw InvalidInput();
+    return gladiators[group.first_gladiator + k - 1].id;
+}
+
+HashTable* FrozenSnapshot::thaw() const {
+    int num_of_groups = header->num_of_groups;
+    if (num_of_groups == 0)
+        return new HashTable();
+    int* ids = new int[num_of_groups];
+    int max_gladiators = 0;
+    for (int i = 0; i < num_of_groups; i++) {
+        ids[i] = groups[i].id;
+        if (groups[i].num_of_gladiators > max_gladiators)
+            max_gladiators = groups[i].num_of_gladiators;
+    }
+    HashTable* table = NULL;
+    Gladiator* buffer = NULL;
+    try {
+        table = new HashTable(ids, num_of_groups);
+        buffer = new Gladiator[max_gladiators > 0 ? max_gladiators : 1];
+        for (int i = 0; i < num_of_groups; i++) {
+            const Snapshot::GladiatorRecord* records =
+                    gladiators + groups[i].first_gladiator;
+            for (int j = 0; j < groups[i].num_of_gladiators; j++)
+                buffer[j] = Gladiator(records[j].id, records[j].score);
+            table->find(groups[i].id).loadGladiators(
+                    buffer, groups[i].num_of_gladiators);
+        }
+    } catch (...) {
+        delete[] ids;
+        delete[] buffer;
+        delete table;
+        throw;
+    }
+    delete[] ids;
+    delete[] buffer;
+    return table;
+}
@@ -0,0 +1,144 @@
+#ifndef DSWET2_SNAPSHOT_H
+#define DSWET2_SNAPSHOT_H
+
+#include "HashTable.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <exception>
+
+/**---------------------------SNAPSHOT----------------------------------
+ * A binary image of a HashTable, its groups and their gladiators.
+ * Layout (native byte order, checked through Header::byte_order):
+ *      Header
+ *      GroupEntry[num_of_groups]           - sorted by group id
+ *      GladiatorRecord[num_of_gladiators]  - the gladiators of each group,
+ *                                            sorted by id, group after group
+ * Each record keeps the prefix sum of the scores in its group, which is the
+ * augmentation the group's tree would compute (rank_weight), so a frozen
+ * snapshot can answer queries without building anything.
+ * The version is bumped on every change of the layout. */
+class Snapshot {
+public:
+    static const uint32_t VERSION = 1;
+    static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    struct Header {
+        char magic[8];                  //"DSWSNAP"
+        uint32_t version;
+        uint32_t byte_order;
+        int32_t num_of_groups;
+        int32_t reserved;
+        int64_t num_of_gladiators;
+        int64_t groups_offset;          //from the start of the file
+        int64_t gladiators_offset;
+    };
+
+    struct GroupEntry {
+        int32_t id;
+        int32_t num_of_gladiators;
+        int64_t first_gladiator;        //index in the records array
+    };
+
+    struct GladiatorRecord {
+        int32_t id;
+        int32_t score;
+        int64_t prefix_score;           //sum of the scores of the group's
+                                        //gladiators up to this one
+    };
+
+    /**WRITE
+     * streams the table through a fixed size buffer to path.tmp, the
+     * snapshot is never held in memory as a whole. Once the file is synced
+     * it is renamed over path, so a failed or interrupted write leaves the
+     * previous snapshot at path as it was.
+     * @exception IOError - the file couldn't be written */
+    static void write(const HashTable& table, const char* path);
+
+    class SnapshotException : public std::exception {
+    };
+
+    class IOError : public SnapshotException {
+    };
+
+    class InvalidFormat : public SnapshotException {
+    };
+};
+
+/**---------------------------FROZEN SNAPSHOT----------------------------
+ * A read only view of a snapshot file. The file is memory mapped and
+ * validated in one sequential pass when opened (bounds, order of the group
+ * and gladiator ids, prefix sums), nothing is copied or built.
+ * Queries match the ones of a group's tree:
+ *      group lookup - binary search over the group entries, O(log groups)
+ *      gladiator lookup, rankWeight - binary search in the group, O(log n)
+ *      select - O(1)
+ * thaw() builds a live HashTable from the view in linear time. */
+class FrozenSnapshot {
+    const char* data;
+    size_t length;
+    const Snapshot::Header* header;
+    const Snapshot::GroupEntry* groups;
+    const Snapshot::GladiatorRecord* gladiators;
+
+    /**@return the entry of group_id
+     * @exception KeyNotFound - no such group */
+    const Snapshot::GroupEntry& findGroup(int group_id) const;
+
+    /**@return the record of gladiator_id in group
+     * @exception KeyNotFound - no such gladiator */
+    const Snapshot::GladiatorRecord&
+    findGladiator(const Snapshot::GroupEntry& group, int gladiator_id) const;
+
+    /**@exception Snapshot::InvalidFormat */
+    void validate() const;
+
+    FrozenSnapshot(const FrozenSnapshot&);
+    FrozenSnapshot& operator=(const FrozenSnapshot&);
+
+public:
+    /**CONSTRUCTOR
+     * maps the snapshot at path
+     * @exception Snapshot::IOError - the file couldn't be mapped
+     * @exception Snapshot::InvalidFormat - not a snapshot of this version or
+     *                                      byte order, truncated, or with
+     *                                      inconsistent records */
+    explicit FrozenSnapshot(const char* path);
+    ~FrozenSnapshot();
+
+    int getNumOfGroups() const;
+
+    bool containsGroup(int group_id) const;
+
+    /**@exception KeyNotFound - no such group */
+    int getNumOfGladiators(int group_id) const;
+
+    /**GET SCORE
+     * @exception KeyNotFound - no such group or gladiator */
+    int getScore(int group_id, int gladiator_id) const;
+
+    /**RANK WEIGHT
+     * @return the sum of the scores of the gladiators of the group with id
+     *         up to gladiator_id (including)
+     * @exception KeyNotFound - no such group or gladiator */
+    long long rankWeight(int group_id, int gladiator_id) const;
+
+    /**SELECT
+     * @return the id of the gladiator with the k-th smallest id in the group
+     * @exception KeyNotFound - no such group
+     * @exception InvalidInput - k isn't in [1, number of gladiators] */
+    int select(int group_id, int k) const;
+
+    /**THAW
+     * builds a live table: the groups are bulk loaded from the sorted ids,
+     * and each group's tree is built from its sorted records. O(size).
+     * @return a new table, owned by the caller */
+    HashTable* thaw() const;
+
+    class KeyNotFound : public Snapshot::SnapshotException {
+    };
+
+    class InvalidInput : public Snapshot::SnapshotException {
+    };
+};
+
+#endif //DSWET2_SNAPSHOT_H
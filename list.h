@@ -3,27 +3,90 @@
 
 #include <iostream>
 #include <cassert>
+#include <cstddef>
+#include <iterator>
 
+#if __cplusplus < 201103L
 #define nullptr NULL
+#endif
 /*---------------------------------------------------------------------------*/
 /* List Class */
 /*---------------------------------------------------------------------------*/
 
 /** generic doubly list class:
- *  Assumptions on T: T has default constructor T()
- *                    T has copy constructor T(T)
+ *  Assumptions on T: T has copy constructor T(T)
  *                    assignment operator=
  *             operator==: List operator== and != require operator ==, != of T.
  *
+ *  The list is circular around a sentinel that is embedded in the list
+ *  object and holds no data: the first item follows it and the last item
+ *  precedes it. An empty list allocates nothing, and T doesn't need a
+ *  default constructor.
+ *
  *  Exceptions: elementNotFound */
 template<class T>
 class List {
+    class NodeBase;
     class Node;
 
-    Node* head;
-    Node* last;
+    /**the sentinel (no data) */
+    class NodeBase {
+        NodeBase* previous;
+        NodeBase* next;
+
+    public:
+        /**constructor- creates a node linked to itself */
+        NodeBase();
+
+        /** get the next node
+         * @return a pointer to the next node to "this" node */
+        NodeBase* getNext() const;
+        /** get the previous node
+         * @return a pointer to the previous node to "this" node */
+        NodeBase* getPrevious() const;
+
+        /**sets the next node to point on the given node
+         * @param node - the node that this node should be pointed to
+         */
+        void setNext(NodeBase* node);
+        /**sets the previous node to point on the given node
+         * @param node - a pointer to the node before "this" */
+        void setPrevious(NodeBase* node);
+    };
+
+    NodeBase header;
     int size;
 
+    /**links node between previous and previous's next */
+    static void linkAfter(NodeBase* previous, NodeBase* node);
+    /**unlinks node from its neighbours */
+    static void unlink(NodeBase* node);
+
+    /**removes and deletes all the items */
+    void clear();
+
+    /**moves the nodes of list to this empty list, list is left empty */
+    void takeNodes(List& list);
+
+    /**restores the previous links and the circle around the sentinel,
+     * after the nodes were chained through next only, ending with NULL */
+    void relinkPrevious();
+
+    /**moves the nodes [first, last] (linked, first up to last) from their
+     * list to before position */
+    static void transfer(NodeBase* position, NodeBase* first, NodeBase* last);
+
+    /**MERGE SORT HELPERS
+     * the runs are chains of nodes linked by next only, ending with NULL.
+     * cut - ends the run after length nodes
+     *       @return the rest of the chain (NULL if there is none)
+     * mergeRuns - links the nodes of two sorted runs after tail, in order
+     *             @return the last node linked */
+    static NodeBase* cut(NodeBase* run, int length);
+    template<class Compare>
+    static NodeBase* mergeRuns(NodeBase* left, NodeBase* right, NodeBase* tail,
+                               const Compare& compare);
+
 public:
     /**constructs a new empty list */
     List();
@@ -39,11 +102,25 @@ public:
     ~List();
 
     /**assignment operator
-     * destroy the old list and assign it to be a copy of the source list
+     * assign the list to be a copy of the source list. The nodes the list
+     * already has are reused (their data is assigned), only the difference
+     * in size is allocated or deleted.
      * @param list - the list to be assigned
      * @return a refernce to the new assigned list */
     List& operator=(const List& list);
 
+#if __cplusplus >= 201103L
+    /**move constructor
+     * takes the nodes of the source list in O(1), the source is left empty.
+     * Iterators to the source are invalidated. */
+    List(List&& list);
+
+    /**move assignment operator
+     * deletes the items of the list and takes the nodes of the source list,
+     * the source is left empty. Iterators to the source are invalidated. */
+    List& operator=(List&& list);
+#endif
+
     /**a class that implementing an internal iterator for the list */
     class Iterator;
 
@@ -76,6 +153,33 @@ public:
      * @param data - The new item to be added to the list */
     void insert(const T& data);
 
+    /**SPLICE
+     * moves items from list to before position, in O(1) besides counting a
+     * range. The nodes are relinked, no data is copied or allocated.
+     * Iterators to the moved items are invalidated (they still refer to
+     * list), all the other iterators stay valid.
+     *  splice(position, list) - all the items of list
+     *  splice(position, list, iterator) - the item iterator points to
+     *  splice(position, list, first, last) - the items [first, last). Counts
+     *                                        the range when list isn't this
+     * @param list - may be this list, except for the whole list version.
+     *               position must not be inside a range moved in this list
+     * @Exceptions: ElementNotFound - position isn't of this list, or an
+     *              iterator isn't of list, or iterator points to the end */
+    void splice(Iterator position, List& list);
+    void splice(Iterator position, List& list, Iterator iterator);
+    void splice(Iterator position, List& list, Iterator first, Iterator last);
+
+    /**MERGE
+     * moves all the items of list into this list, both sorted by compare.
+     * The result is sorted and stable: equal items of this list come first.
+     * O(n + m) comparisons, the nodes are relinked, list is left empty.
+     * Iterators to the items of list are invalidated.
+     * @tparam Compare - like for sort
+     * @param list - another list */
+    template<class Compare>
+    void merge(List& list, const Compare& compare);
+
     /**removes the item the iterator points to from the list
      * @param iterator - points to the item to remove
      * @Exceptions: ElementNotFound - the list is empty or the iterator is
@@ -97,6 +201,10 @@ public:
     /**sorts the list by the compare function.
      *The list will be sorted as every 2 successive items o1,o2 will return true
      * in compare(o1,o2)
+     * A bottom-up merge sort: O(n log n) comparisons, O(1) extra memory. The
+     * nodes are relinked, the data is never copied, and iterators keep
+     * pointing to the same items. Stable, as long as compare(o1,o2) is true
+     * for equal items (like <=).
      * @tparam Compare - A function object that gets 2 parameters and return
      *                     true or false
      * @param compare - the compare function by which 2 items will be compared*/
@@ -126,37 +234,16 @@ public:
 /*---------------------------------------------------------------------------*/
 
 /**generic node class that implement the list nodes.
- * store the data, the next and the previous nodes to each node. */
+ * store the data in addition to the links of NodeBase. */
 template<class T>
-class List<T>::Node {
+class List<T>::Node : public List<T>::NodeBase {
     T data;
-    Node* previous;
-    Node* next;
 
 public:
-    /**constructor- creates node with a T data with the default constructor T()
-     * the node will be before and after nullptr*/
-    Node();
-
-    /**constructor- creates node with a T data and set the next and previous
-     * nodes to nullptr. data will be copied by the copy constructor of T
+    /**constructor- creates node with a T data, linked to itself. data will
+     * be copied by the copy constructor of T
      * @param data - the data to put inside the node */
-    explicit Node(T data);
-
-    /** get the next node
-     * @return a pointer to the next node to "this" node */
-    Node* getNext() const;
-    /** get the previous node
-     * @return a pointer to the previous node to "this" node */
-    Node* getPrevious() const;
-
-    /**sets the next node to point on the given node
-     * @param node - the node that this node should be pointed to
-     */
-    void setNext(Node* node);
-    /**sets the previous node to point on the given node
-     * @param node - a pointer to the node before "this" */
-    void setPrevious(Node* node);
+    explicit Node(const T& data);
 
     /**return the data in the node
      * @return - referance to the node's data */
@@ -164,7 +251,7 @@ public:
 
     /**change the data of the node
      * @param new_data - the new data should be put in the node */
-    void setData(T& new_data);
+    void setData(const T& new_data);
 };
 
 /*---------------------------------------------------------------------------*/
@@ -173,39 +260,54 @@ public:
 
 /**class of list that implements an iterator.
  * The iterator implemented as a pointer to one of the list's nodes. when it
- * reach the end of the list it points to the dummy last node.
+ * reach the end of the list it points to the list's sentinel.
  * In addition the iterator holds a pointer to the list to which it belongs */
 template<class T>
 class List<T>::Iterator {
     const List<T>* list;
-    Node* current;
+    NodeBase* current;
 
     /**constuctor
      * creates a new iterator to the given list that points to one of the nodes
      * @param list - pointer tothe list to which the iteraotr belongs
      * @param current - pointer to the node the iterator points to*/
-    Iterator(const List<T>* list, Node* current);
+    Iterator(const List<T>* list, NodeBase* current);
 
     friend class List<T>;
 
 public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T* pointer;
+    typedef T& reference;
+
+    /**default constructor
+     * creates a singular iterator, that may only be assigned to */
+    Iterator();
 
     /**Dereference operator
-     * return the data to which the iterator points to
-     * @return T type data of the current position of the iterator*/
-    T& operator*();
+     * return the data to which the iterator points to. Checked only in debug
+     * builds (without NDEBUG), dereferencing end() is undefined otherwise.
+     * @return T type data of the current position of the iterator
+     * @Exceptions: ElementNotFound - debug builds, the iterator points to the
+     *              end of the list */
+    T& operator*() const;
+
+    /**member access operator, like operator* */
+    T* operator->() const;
 
     /**++ operator
      * advance the iterator to the next node and return the iterator after the
      * change.
-     * If the iterator points to the end of the list (last node). The action is
+     * If the iterator points to the end of the list (the sentinel). The action is
      * not defined (will remain at the same node)
      * @return - reference to the iterator itself after the change */
     Iterator& operator++();
     /**operator ++
      * advance the iterator to the next node and return a copy of iterator
      * before the change.
-     * If the iterator points to the end of the list (last node). The action is
+     * If the iterator points to the end of the list (the sentinel). The action is
      * not defined (will remain at the same node)
      * @return - a copy of the iterator before the change */
     Iterator operator++(int);
@@ -228,7 +330,7 @@ public:
     /**comparison operators
      * compare two iterator and return if they are equals. Iterator considered
      * equals if they belong to the same list and points to the same node.
-     * (if both points to the last node they are equal as weel
+     * (if both points to the sentinel they are equal as weel
      * @param iterator - the iterator "this" should be compare to
      * @return ==: true if equals. !=: true if not equals */
     bool operator==(const Iterator& iterator) const;
@@ -241,31 +343,38 @@ public:
 /*---------------------------------------------------------------------------*/
 
 template<class T>
-List<T>::List() : head(new Node),
-                  last(new Node), size(0) {
-    head->setNext(last);
-    last->setPrevious(head);
+List<T>::List() : header(), size(0) {
 }
 
 template<class T>
-List<T>::List(const List& list) : head(new Node()), last(new Node()), size(0) {
-    head->setNext(last);
-    last->setPrevious(head);
-    for (Iterator it = list.begin(); it != list.end(); it++) {
-        this->insert(*it);
+List<T>::List(const List& list) : header(), size(0) {
+    try {
+        for (Iterator it = list.begin(); it != list.end(); it++) {
+            this->insert(*it);
+        }
+    } catch (...) {
+        clear();
+        throw;
     }
     assert(size == list.size);
 }
 
 template<class T>
 List<T>::~List() {
-    Iterator it = begin();
-    while (it != end()) {
-        Iterator to_delete = it++;
-        remove(to_delete);
+    clear();
+}
+
+template<class T>
+void List<T>::clear() {
+    NodeBase* current = header.getNext();
+    while (current != &header) {
+        NodeBase* next = current->getNext();
+        delete static_cast<Node*>(current);
+        current = next;
     }
-    delete head;
-    delete last;
+    header.setNext(&header);
+    header.setPrevious(&header);
+    size = 0;
 }
 
 template<class T>
@@ -273,26 +382,176 @@ List<T>& List<T>::operator=(const List& list) {
     if (this == &list) {
         return *this;
     }
-    Iterator it = begin();
-    while (it != end()) {
-        Iterator to_delete = it++;
-        remove(to_delete);
+    NodeBase* target = header.getNext();
+    Iterator source = list.begin();
+    for (; target != &header && source != list.end(); source++) {
+        static_cast<Node*>(target)->setData(*source);
+        target = target->getNext();
     }
-    assert(size == 0);
-    for (it = list.begin(); it != list.end(); it++) {
-        this->insert(*it);
+    while (target != &header) { //this list was longer
+        NodeBase* next = target->getNext();
+        unlink(target);
+        delete static_cast<Node*>(target);
+        size--;
+        target = next;
+    }
+    for (; source != list.end(); source++) {
+        this->insert(*source);
+    }
+    assert(size == list.size);
+    return *this;
+}
+
+#if __cplusplus >= 201103L
+template<class T>
+List<T>::List(List&& list) : header(), size(0) {
+    takeNodes(list);
+}
+
+template<class T>
+List<T>& List<T>::operator=(List&& list) {
+    if (this != &list) {
+        clear();
+        takeNodes(list);
     }
     return *this;
 }
+#endif
+
+template<class T>
+void List<T>::takeNodes(List& list) {
+    assert(size == 0);
+    if (list.size == 0) {
+        return;
+    }
+    header.setNext(list.header.getNext());
+    header.setPrevious(list.header.getPrevious());
+    header.getNext()->setPrevious(&header);
+    header.getPrevious()->setNext(&header);
+    size = list.size;
+    list.header.setNext(&list.header);
+    list.header.setPrevious(&list.header);
+    list.size = 0;
+}
+
+template<class T>
+void List<T>::relinkPrevious() {
+    NodeBase* previous = &header;
+    for (NodeBase* node = header.getNext(); node != NULL;
+         node = node->getNext()) {
+        node->setPrevious(previous);
+        previous = node;
+    }
+    previous->setNext(&header);
+    header.setPrevious(previous);
+}
+
+template<class T>
+void List<T>::transfer(NodeBase* position, NodeBase* first, NodeBase* last) {
+    //cut [first, last] out of its list
+    first->getPrevious()->setNext(last->getNext());
+    last->getNext()->setPrevious(first->getPrevious());
+    //and link it before position
+    NodeBase* previous = position->getPrevious();
+    previous->setNext(first);
+    first->setPrevious(previous);
+    last->setNext(position);
+    position->setPrevious(last);
+}
+
+template<class T>
+void List<T>::splice(Iterator position, List& list) {
+    if (this != position.list || this == &list) {
+        throw ElementNotFound();
+    }
+    if (list.size == 0) {
+        return;
+    }
+    transfer(position.current, list.header.getNext(),
+             list.header.getPrevious());
+    size += list.size;
+    list.size = 0;
+}
+
+template<class T>
+void List<T>::splice(Iterator position, List& list, Iterator iterator) {
+    if (this != position.list || &list != iterator.list ||
+        iterator == list.end()) {
+        throw ElementNotFound();
+    }
+    if (position.current == iterator.current ||
+        position.current == iterator.current->getNext()) {
+        return; //already in place
+    }
+    transfer(position.current, iterator.current, iterator.current);
+    size++;
+    list.size--;
+}
+
+template<class T>
+void List<T>::splice(Iterator position, List& list, Iterator first,
+                     Iterator last) {
+    if (this != position.list || &list != first.list ||
+        &list != last.list) {
+        throw ElementNotFound();
+    }
+    if (first == last) {
+        return;
+    }
+    if (this != &list) {
+        int moved = 0;
+        for (NodeBase* node = first.current; node != last.current;
+             node = node->getNext()) {
+            moved++;
+        }
+        size += moved;
+        list.size -= moved;
+    }
+    transfer(position.current, first.current, last.current->getPrevious());
+}
+
+template<class T>
+template<class Compare>
+void List<T>::merge(List& list, const Compare& compare) {
+    if (this == &list || list.size == 0) {
+        return;
+    }
+    //both lists become NULL ended chains, merged after the sentinel
+    NodeBase* left = size > 0 ? header.getNext() : NULL;
+    header.getPrevious()->setNext(NULL);
+    NodeBase* right = list.header.getNext();
+    list.header.getPrevious()->setNext(NULL);
+    mergeRuns(left, right, &header, compare);
+    relinkPrevious();
+    size += list.size;
+    list.header.setNext(&list.header);
+    list.header.setPrevious(&list.header);
+    list.size = 0;
+}
 
 template<class T>
 typename List<T>::Iterator List<T>::begin() const {
-    return Iterator(this, head->getNext());
+    return Iterator(this, header.getNext());
 }
 
 template<class T>
 typename List<T>::Iterator List<T>::end() const {
-    return Iterator(this, last);
+    return Iterator(this, const_cast<NodeBase*>(&header));
+}
+
+template<class T>
+void List<T>::linkAfter(NodeBase* previous, NodeBase* node) {
+    NodeBase* next = previous->getNext();
+    node->setPrevious(previous);
+    node->setNext(next);
+    previous->setNext(node);
+    next->setPrevious(node);
+}
+
+template<class T>
+void List<T>::unlink(NodeBase* node) {
+    node->getPrevious()->setNext(node->getNext());
+    node->getNext()->setPrevious(node->getPrevious());
 }
 
 
@@ -303,12 +562,7 @@ int List<T>::getSize() const {
 
 template<class T>
 void List<T>::insert(const T& data) {
-    Node* new_node = new Node(data);
-    Node* previous = last->getPrevious();
-    (*previous).setNext(new_node);
-    (*new_node).setNext(last);
-    last->setPrevious(new_node);
-    (*new_node).setPrevious(previous);
+    linkAfter(header.getPrevious(), new Node(data));
     size++;
 }
 
@@ -317,12 +571,7 @@ void List<T>::insert(const T& data, Iterator iterator) {
     if (this != iterator.list) {
         throw ElementNotFound();
     }
-    Node* new_node = new Node(data);
-    Node* previous = iterator.current->getPrevious();
-    (*new_node).setPrevious(previous);
-    (*previous).setNext(new_node);
-    (*new_node).setNext(iterator.current);
-    iterator.current->setPrevious(new_node);
+    linkAfter(iterator.current->getPrevious(), new Node(data));
     size++;
 }
 
@@ -331,11 +580,8 @@ void List<T>::remove(Iterator iterator) {
     if (this != iterator.list || iterator == end() || getSize() == 0) {
         throw ElementNotFound();
     }
-    Node* previous = iterator.current->getPrevious();
-    Node* next = iterator.current->getNext();
-    (*previous).setNext(next);
-    (*next).setPrevious(previous);
-    delete iterator.current;
+    unlink(iterator.current);
+    delete static_cast<Node*>(iterator.current);
     size--;
 }
 
@@ -352,28 +598,63 @@ typename List<T>::Iterator List<T>::find(const Predicate& predicate) const {
     return iterator;
 }
 
+template<class T>
+typename List<T>::NodeBase* List<T>::cut(NodeBase* run, int length) {
+    for (int i = 1; run != NULL && i < length; i++) {
+        run = run->getNext();
+    }
+    if (run == NULL) {
+        return NULL;
+    }
+    NodeBase* rest = run->getNext();
+    run->setNext(NULL);
+    return rest;
+}
+
+template<class T>
+template<class Compare>
+typename List<T>::NodeBase* List<T>::mergeRuns(NodeBase* left, NodeBase* right,
+                                               NodeBase* tail,
+                                               const Compare& compare) {
+    while (left != NULL && right != NULL) {
+        //ties go to the left run, this keeps the sort stable
+        if (compare(static_cast<Node*>(left)->getData(),
+                    static_cast<Node*>(right)->getData())) {
+            tail->setNext(left);
+            left = left->getNext();
+        } else {
+            tail->setNext(right);
+            right = right->getNext();
+        }
+        tail = tail->getNext();
+    }
+    tail->setNext(left != NULL ? left : right);
+    while (tail->getNext() != NULL) {
+        tail = tail->getNext();
+    }
+    return tail;
+}
+
 template<class T>
 template<class Compare>
 void List<T>::sort(const Compare& compare) {
-    bool not_sorted = true;
-    int len = size - 1;
-    while (len > 0 && not_sorted) {
-        not_sorted = false;
-        Iterator it = begin();
-        for (int i = 0; i < len; i++) {
-            Iterator next = it;
-            next++;
-            assert(next != end());
-            if (compare(*it, *next) == false) {
-                T temp = *it;
-                it.current->setData(*next);
-                next.current->setData(temp);
-                not_sorted = true;
-            }
-            it++;
+    if (size < 2) {
+        return;
+    }
+    //the runs are chained through next only and end with NULL, the
+    //previous links are restored once at the end
+    header.getPrevious()->setNext(NULL);
+    for (int width = 1; width < size; width *= 2) {
+        NodeBase* remaining = header.getNext();
+        NodeBase* tail = &header;
+        while (remaining != NULL) {
+            NodeBase* left = remaining;
+            NodeBase* right = cut(left, width);
+            remaining = cut(right, width);
+            tail = mergeRuns(left, right, tail, compare);
         }
-        len--;
     }
+    relinkPrevious();
 }
 
 template<class T>
@@ -401,40 +682,40 @@ bool List<T>::operator!=(const List& list) const {
 /*---------------------------------------------------------------------------*/
 
 template<class T>
-List<T>::Node::Node() :previous(nullptr), next(nullptr) {
+List<T>::NodeBase::NodeBase() : previous(this), next(this) {
 }
 
 template<class T>
-List<T>::Node::Node(T data) : data(data), previous(nullptr), next(nullptr) {
+typename List<T>::NodeBase* List<T>::NodeBase::getNext() const {
+    return this->next;
 }
 
 template<class T>
-typename List<T>::Node* List<T>::Node::getNext() const {
-    return this->next;
+typename List<T>::NodeBase* List<T>::NodeBase::getPrevious() const {
+    return this->previous;
 }
 
 template<class T>
-typename List<T>::Node* List<T>::Node::getPrevious() const {
-    return this->previous;
+void List<T>::NodeBase::setNext(NodeBase* node) {
+    this->next = node;
 }
 
 template<class T>
-T& List<T>::Node::getData() {
-    return this->data;
+void List<T>::NodeBase::setPrevious(NodeBase* node) {
+    this->previous = node;
 }
 
 template<class T>
-void List<T>::Node::setNext(Node* node) {
-    this->next = node;
+List<T>::Node::Node(const T& data) : NodeBase(), data(data) {
 }
 
 template<class T>
-void List<T>::Node::setPrevious(Node* node) {
-    this->previous = node;
+T& List<T>::Node::getData() {
+    return this->data;
 }
 
 template<class T>
-void List<T>::Node::setData(T& new_data) {
+void List<T>::Node::setData(const T& new_data) {
     data = new_data;
 }
 
@@ -443,21 +724,32 @@ void List<T>::Node::setData(T& new_data) {
 /*---------------------------------------------------------------------------*/
 
 template<class T>
-List<T>::Iterator::Iterator(const List<T>* list, Node* current): list(list),
-                                                                 current(current) {
+List<T>::Iterator::Iterator(const List<T>* list, NodeBase* current): list(list),
+                                                                     current(current) {
+}
+
+template<class T>
+List<T>::Iterator::Iterator() : list(NULL), current(NULL) {
 }
 
 template<class T>
-T& List<T>::Iterator::operator*() {
-    if (current == list->last || current == list->head) {
+T& List<T>::Iterator::operator*() const {
+#ifndef NDEBUG
+    if (current == &list->header) {
         throw ElementNotFound();
     }
-    return (*current).getData();
+#endif
+    return static_cast<Node*>(current)->getData();
+}
+
+template<class T>
+T* List<T>::Iterator::operator->() const {
+    return &**this;
 }
 
 template<class T>
 typename List<T>::Iterator& List<T>::Iterator::operator++() {
-    if (*this != list->end()) {
+    if (current != &list->header) {
         current = current->getNext();
     }
     return *this;
@@ -472,7 +764,7 @@ typename List<T>::Iterator List<T>::Iterator::operator++(int) {
 
 template<class T>
 typename List<T>::Iterator& List<T>::Iterator::operator--() {
-    if (current->getPrevious() == list->head) return *this;
+    if (current->getPrevious() == &list->header) return *this;
     current = current->getPrevious();
     return *this;
 }
@@ -1,15 +1,155 @@
-#include "HashTable.h"
+#include "BatchDriver.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**read size of a non regular input (a pipe), which can't be mapped */
+#define INPUT_CHUNK_SIZE (1 << 20)
+
+/**---------------------------INPUT----------------------------------
+ * The whole input in memory. A regular file is mapped, so the driver
+ * parses the page cache in place, anything else is read to a buffer. */
+class Input {
+    char* data;
+    size_t length;
+    bool mapped;
+
+    Input(const Input&);
+    Input& operator=(const Input&);
+
+    /**@return false on a read error, errno is set */
+    bool read(int fd) {
+        size_t capacity = 0;
+        while (true) {
+            if (length + INPUT_CHUNK_SIZE > capacity) {
+                capacity = capacity * 2 + INPUT_CHUNK_SIZE;
+                char* grown = (char*) realloc(data, capacity);
+                if (grown == NULL) {
+                    errno = ENOMEM;
+                    return false;
+                }
+                data = grown;
+            }
+            ssize_t result = ::read(fd, data + length, capacity - length);
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result < 0)
+                return false;
+            if (result == 0)
+                return true;
+            length += result;
+        }
+    }
 
-class GetKey {
 public:
-    bool operator()(int n) {
-        return n;
+    Input() : data(NULL), length(0), mapped(false) {}
+
+    ~Input() {
+        if (mapped)
+            munmap(data, length);
+        else
+            free(data);
+    }
+
+    /**@return false on an error, errno is set */
+    bool load(int fd) {
+        struct stat status;
+        if (fstat(fd, &status) != 0)
+            return false;
+        if (!S_ISREG(status.st_mode) || status.st_size == 0)
+            return read(fd);
+        void* address = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE,
+                             fd, 0);
+        if (address == MAP_FAILED)
+            return read(fd);
+        madvise(address, status.st_size, MADV_SEQUENTIAL);
+        data = (char*) address;
+        length = status.st_size;
+        mapped = true;
+        return true;
+    }
+
+    const char* getData() const {
+        return data;
+    }
+
+    size_t getLength() const {
+        return length;
     }
 };
 
-int main() {
-    int a[2] = {3, 2};
-    HashTable<int, GetKey> hash(a, 2);
-    return 0;
+static double seconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
 }
 
+/**usage: main [file]
+ * runs the operations of file, or of the standard input, against a new
+ * colosseum (see BatchDriver for the encodings), writes the results to the
+ * standard output and the throughput to the standard error.
+ * Exits with 1 if the input can't be read or is malformed, or the output
+ * can't be written */
+int main(int argc, char** argv) {
+    if (argc > 2) {
+        fprintf(stderr, "usage: %s [file]\n", argv[0]);
+        return 1;
+    }
+    int fd = STDIN_FILENO;
+    const char* name = "<stdin>";
+    if (argc == 2) {
+        name = argv[1];
+        fd = open(name, O_RDONLY);
+        if (fd < 0) {
+            fprintf(stderr, "%s: %s\n", name, strerror(errno));
+            return 1;
+        }
+    }
+    Input input;
+    double start = seconds();
+    bool loaded = input.load(fd);
+    if (fd != STDIN_FILENO)
+        close(fd);
+    if (!loaded) {
+        fprintf(stderr, "%s: %s\n", name, strerror(errno));
+        return 1;
+    }
+
+    Colosseum colosseum;
+    BatchDriver driver(colosseum, STDOUT_FILENO);
+    int result = 0;
+    double run_start = seconds();
+    try {
+        driver.run(input.getData(), input.getLength());
+        driver.flush();
+    } catch (BatchDriver::InvalidFormat& e) {
+        try {
+            driver.flush();
+        } catch (BatchDriver::IOError&) {
+        }
+        fprintf(stderr, "%s: malformed operation at %lld\n", name,
+                e.getPosition());
+        result = 1;
+    } catch (BatchDriver::IOError&) {
+        fprintf(stderr, "<stdout>: %s\n", strerror(errno));
+        result = 1;
+    }
+    double end = seconds();
+
+    const BatchDriver::Statistics& statistics = driver.getStatistics();
+    double run_time = end - run_start > 0 ? end - run_start : 1e-9;
+    fprintf(stderr, "%lld operations (%lld queries, %lld failed) in %.3f s"
+                    " (%.3f s loading): %.0f ops/s, %.1f MB/s in, "
+                    "%.1f MB/s out\n",
+            statistics.operations, statistics.queries, statistics.failed,
+            run_time, run_start - start, statistics.operations / run_time,
+            statistics.bytes_read / run_time / 1e6,
+            statistics.bytes_written / run_time / 1e6);
+    return result;
+}
@@ -0,0 +1,182 @@
+
+#ifndef DSWET2_SCOREREDUCE_H
+#define DSWET2_SCOREREDUCE_H
+
+#include <cassert>
+
+/**---------------------------SCORE REDUCE----------------------------------
+ * Reductions over contiguous int arrays (the score columns of a group):
+ * sum, minimum, maximum and the number of values above a threshold. They
+ * read the array once, in order, a whole vector at a time, so a large
+ * array is reduced at about the speed memory delivers it.
+ * The implementation is picked at compile time:
+ *      AVX2     - 8 values per step
+ *      SSE2     - 4 values per step (min and max emulated with compares)
+ *      portable - one value per step
+ * Define REDUCE_PORTABLE to force the portable implementation. The values
+ * left after the last full vector are reduced one by one. */
+
+#if defined(__AVX2__) && !defined(REDUCE_PORTABLE)
+#include <immintrin.h>
+#define REDUCE_AVX2
+#elif defined(__SSE2__) && !defined(REDUCE_PORTABLE)
+#include <emmintrin.h>
+#define REDUCE_SSE2
+#endif
+
+namespace reduce {
+
+#if defined(REDUCE_SSE2)
+    /**SSE2 has no 32 bit min and max, they are picked by a compare */
+    inline __m128i max4(__m128i a, __m128i b) {
+        __m128i greater = _mm_cmpgt_epi32(a, b);
+        return _mm_or_si128(_mm_and_si128(greater, a),
+                            _mm_andnot_si128(greater, b));
+    }
+
+    inline __m128i min4(__m128i a, __m128i b) {
+        __m128i greater = _mm_cmpgt_epi32(a, b);
+        return _mm_or_si128(_mm_and_si128(greater, b),
+                            _mm_andnot_si128(greater, a));
+    }
+#endif
+
+    /**SUM
+     * @return the sum of values[0..n), in 64 bits, so it doesn't overflow */
+    inline long long sum(const int* values, int n) {
+        long long result = 0;
+        int i = 0;
+#if defined(REDUCE_AVX2)
+        __m256i low = _mm256_setzero_si256();
+        __m256i high = _mm256_setzero_si256();
+        for (; i + 8 <= n; i += 8) {
+            __m256i v = _mm256_loadu_si256((const __m256i*) (values + i));
+            low = _mm256_add_epi64(low, _mm256_cvtepi32_epi64(
+                    _mm256_castsi256_si128(v)));
+            high = _mm256_add_epi64(high, _mm256_cvtepi32_epi64(
+                    _mm256_extracti128_si256(v, 1)));
+        }
+        long long lanes[4];
+        _mm256_storeu_si256((__m256i*) lanes, _mm256_add_epi64(low, high));
+        result = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(REDUCE_SSE2)
+        __m128i total = _mm_setzero_si128();
+        for (; i + 4 <= n; i += 4) {
+            __m128i v = _mm_loadu_si128((const __m128i*) (values + i));
+            //sign extends to 64 bits by pairing each value with its sign
+            __m128i sign = _mm_srai_epi32(v, 31);
+            total = _mm_add_epi64(total, _mm_unpacklo_epi32(v, sign));
+            total = _mm_add_epi64(total, _mm_unpackhi_epi32(v, sign));
+        }
+        long long lanes[2];
+        _mm_storeu_si128((__m128i*) lanes, total);
+        result = lanes[0] + lanes[1];
+#endif
+        for (; i < n; i++)
+            result += values[i];
+        return result;
+    }
+
+    /**MAX
+     * @return the largest of values[0..n), n > 0 */
+    inline int max(const int* values, int n) {
+        assert(n > 0);
+        int result = values[0];
+        int i = 0;
+#if defined(REDUCE_AVX2)
+        if (n >= 8) {
+            __m256i best = _mm256_loadu_si256((const __m256i*) values);
+            for (i = 8; i + 8 <= n; i += 8)
+                best = _mm256_max_epi32(best, _mm256_loadu_si256(
+                        (const __m256i*) (values + i)));
+            int lanes[8];
+            _mm256_storeu_si256((__m256i*) lanes, best);
+            for (int lane = 0; lane < 8; lane++)
+                result = lanes[lane] > result ? lanes[lane] : result;
+        }
+#elif defined(REDUCE_SSE2)
+        if (n >= 4) {
+            __m128i best = _mm_loadu_si128((const __m128i*) values);
+            for (i = 4; i + 4 <= n; i += 4)
+                best = max4(best, _mm_loadu_si128(
+                        (const __m128i*) (values + i)));
+            int lanes[4];
+            _mm_storeu_si128((__m128i*) lanes, best);
+            for (int lane = 0; lane < 4; lane++)
+                result = lanes[lane] > result ? lanes[lane] : result;
+        }
+#endif
+        for (; i < n; i++)
+            result = values[i] > result ? values[i] : result;
+        return result;
+    }
+
+    /**MIN
+     * @return the smallest of values[0..n), n > 0 */
+    inline int min(const int* values, int n) {
+        assert(n > 0);
+        int result = values[0];
+        int i = 0;
+#if defined(REDUCE_AVX2)
+        if (n >= 8) {
+            __m256i best = _mm256_loadu_si256((const __m256i*) values);
+            for (i = 8; i + 8 <= n; i += 8)
+                best = _mm256_min_epi32(best, _mm256_loadu_si256(
+                        (const __m256i*) (values + i)));
+            int lanes[8];
+            _mm256_storeu_si256((__m256i*) lanes, best);
+            for (int lane = 0; lane < 8; lane++)
+                result = lanes[lane] < result ? lanes[lane] : result;
+        }
+#elif defined(REDUCE_SSE2)
+        if (n >= 4) {
+            __m128i best = _mm_loadu_si128((const __m128i*) values);
+            for (i = 4; i + 4 <= n; i += 4)
+                best = min4(best, _mm_loadu_si128(
+                        (const __m128i*) (values + i)));
+            int lanes[4];
+            _mm_storeu_si128((__m128i*) lanes, best);
+            for (int lane = 0; lane < 4; lane++)
+                result = lanes[lane] < result ? lanes[lane] : result;
+        }
+#endif
+        for (; i < n; i++)
+            result = values[i] < result ? values[i] : result;
+        return result;
+    }
+
+    /**COUNT ABOVE
+     * @return the number of values in values[0..n) larger than threshold */
+    inline int countAbove(const int* values, int n, int threshold) {
+        int result = 0;
+        int i = 0;
+#if defined(REDUCE_AVX2)
+        //a compare sets a lane to -1, subtracting it counts the lane
+        __m256i counts = _mm256_setzero_si256();
+        __m256i bound = _mm256_set1_epi32(threshold);
+        for (; i + 8 <= n; i += 8)
+            counts = _mm256_sub_epi32(counts, _mm256_cmpgt_epi32(
+                    _mm256_loadu_si256((const __m256i*) (values + i)),
+                    bound));
+        int lanes[8];
+        _mm256_storeu_si256((__m256i*) lanes, counts);
+        for (int lane = 0; lane < 8; lane++)
+            result += lanes[lane];
+#elif defined(REDUCE_SSE2)
+        __m128i counts = _mm_setzero_si128();
+        __m128i bound = _mm_set1_epi32(threshold);
+        for (; i + 4 <= n; i += 4)
+            counts = _mm_sub_epi32(counts, _mm_cmpgt_epi32(
+                    _mm_loadu_si128((const __m128i*) (values + i)), bound));
+        int lanes[4];
+        _mm_storeu_si128((__m128i*) lanes, counts);
+        for (int lane = 0; lane < 4; lane++)
+            result += lanes[lane];
+#endif
+        for (; i < n; i++)
+            result += values[i] > threshold ? 1 : 0;
+        return result;
+    }
+}
+
+#endif //DSWET2_SCOREREDUCE_H
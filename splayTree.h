@@ -12,25 +12,27 @@ namespace trees {
     /**SPLAY SEARCH TREE
      * @tparam T - Type of data the tree would keep
      * @tparam Key - The key by which the tree will be sorted
-     *               Key should overload comparision operators <,>,= */
-    template<class T, class Key>
-    class Splay : public BST<T, Key> {
+     * @tparam Compare - three way comparison of keys, see BST
+     * @tparam KeyOf - where a node's key comes from, see BST */
+    template<class T, class Key, class Compare = ThreeWayCompare<Key>,
+             class KeyOf = StoredKey<T, Key> >
+    class Splay : public BST<T, Key, Compare, KeyOf> {
 
         /**SPLAY
          * splaying to_splay to the root
          * @param to_splay - the node should be splayed */
-        void splay(typename BST<T, Key>::Node* to_splay);
+        void splay(typename BST<T, Key, Compare, KeyOf>::Node* to_splay);
 
         /**ROTATE RIGHT
          * rotating n to the right (LL rotation)
          * @param n
          */
-        void rotateRight(typename BST<T, Key>::Node* n);
+        void rotateRight(typename BST<T, Key, Compare, KeyOf>::Node* n);
 
         /**ROTATE LEFT
          * rotating n to the left (RR rotation)
          * @param n  */
-        void rotateLeft(typename BST<T, Key>::Node* n);
+        void rotateLeft(typename BST<T, Key, Compare, KeyOf>::Node* n);
 
     public:
         /**INSERT
@@ -58,6 +60,12 @@ namespace trees {
          *                          the parent of the key would have been, is spalyed*/
         T remove(const Key& key); //override;
 
+        /**UPDATE
+         * replaces the data and value of key's node and splays it to the root
+         * @exception KeyNotFound - there is no node with the wanted key in tree
+         *                          the parent of the key would have been, is spalyed*/
+        void update(const Key& key, const T& data, int value); //override;
+
 
         /**FIND MIN
          * finding the min in the tree by key, splay it and return its data
@@ -71,12 +79,30 @@ namespace trees {
 
         Key select(int k);
 
-        int rank_weight(Key x);
+        long long rank_weight(Key x);
+
+        /**RANK
+         * splays x to the root, its rank is then the size of the left sub-tree
+         * @return the number of keys up to x, including x
+         * @exception KeyNotFound - x isn't in the tree */
+        int rank(Key x);
+
+        /**PREFIX WEIGHT
+         * sums the values of the k smallest keys in a single descent, then
+         * splays the last node visited, which keeps the bound amortized
+         * O(log n) without a second search.
+         * @exception InvalidInput - k is out of range */
+        long long prefixWeight(int k); //override
+
+        /**COUNT LESS
+         * counts the keys smaller than key in a single descent, then splays
+         * the last node visited */
+        int countLess(const Key& key); //override
     };
 
-    template<class T, class Key>
-    void Splay<T, Key>::rotateRight(typename BST<T, Key>::Node* n) {
-        typename BST<T, Key>::Node* parent = n->parent;
+    template<class T, class Key, class Compare, class KeyOf>
+    void Splay<T, Key, Compare, KeyOf>::rotateRight(typename BST<T, Key, Compare, KeyOf>::Node* n) {
+        typename BST<T, Key, Compare, KeyOf>::Node* parent = n->parent;
         n->parent->left_son = n->right_son;
         if (n->right_son)
             n->right_son->parent = parent;
@@ -89,10 +115,10 @@ namespace trees {
         this->update_ranks(n);
     }
 
-    template<class T, class Key>
-    void Splay<T, Key>::rotateLeft(typename BST<T, Key>::Node* n) {
+    template<class T, class Key, class Compare, class KeyOf>
+    void Splay<T, Key, Compare, KeyOf>::rotateLeft(typename BST<T, Key, Compare, KeyOf>::Node* n) {
         assert(n->parent);
-        typename BST<T, Key>::Node* parent = n->parent;
+        typename BST<T, Key, Compare, KeyOf>::Node* parent = n->parent;
         parent->right_son = n->left_son;
         if (n->left_son)
             n->left_son->parent = parent;
@@ -105,80 +131,75 @@ namespace trees {
         this->update_ranks(n);
     }
 
-    template<class T, class Key>
-    void Splay<T, Key>::splay(typename BST<T, Key>::Node* to_splay) {
+    template<class T, class Key, class Compare, class KeyOf>
+    void Splay<T, Key, Compare, KeyOf>::splay(typename BST<T, Key, Compare, KeyOf>::Node* to_splay) {
         if (to_splay == NULL) return; //empty tree
-        if (to_splay->parent == NULL) { //splayed is already root
-            this->root = to_splay;
-            return;
-        }
-        typename BST<T, Key>::Node* grandP = to_splay->parent->parent;
-        /*child of root*/
-        if (grandP == NULL) {
-            if (to_splay->parent->left_son == to_splay)//left child of root
+        while (to_splay->parent != NULL) { //until splayed is root
+            typename BST<T, Key, Compare, KeyOf>::Node* grandP = to_splay->parent->parent;
+            /*child of root*/
+            if (grandP == NULL) {
+                if (to_splay->parent->left_son == to_splay)//left child of root
+                    rotateRight(to_splay);
+                else                            //right child of root
+                    rotateLeft(to_splay);
+                break;
+            }
+            /*has grandfather*/
+            if (grandP->left_son && grandP->left_son->left_son == to_splay) { //LL
+                rotateRight(to_splay->parent);
                 rotateRight(to_splay);
-            else                            //right child of root
+            } else if (grandP->left_son &&
+                       grandP->left_son->right_son == to_splay) { //LR
                 rotateLeft(to_splay);
-            this->root = to_splay;
-            return;
-        }
-        /*has grandfather*/
-        if (grandP->left_son && grandP->left_son->left_son == to_splay) { //LL
-            rotateRight(to_splay->parent);
-            rotateRight(to_splay);
-        } else if (grandP->left_son &&
-                   grandP->left_son->right_son == to_splay) { //LR
-            rotateLeft(to_splay);
-            rotateRight(to_splay);
-        } else if (grandP->right_son &&
-                   grandP->right_son->left_son == to_splay) { //RL
-            rotateRight(to_splay);
-            rotateLeft(to_splay);
-        } else if (grandP->right_son &&
-                   grandP->right_son->right_son == to_splay) { //RR
-            rotateLeft(to_splay->parent);
-            rotateLeft(to_splay);
+                rotateRight(to_splay);
+            } else if (grandP->right_son &&
+                       grandP->right_son->left_son == to_splay) { //RL
+                rotateRight(to_splay);
+                rotateLeft(to_splay);
+            } else if (grandP->right_son &&
+                       grandP->right_son->right_son == to_splay) { //RR
+                rotateLeft(to_splay->parent);
+                rotateLeft(to_splay);
+            }
         }
-
-        /*run again*/
-        splay(to_splay);
+        this->root = to_splay;
     }
 
-    template<class T, class Key>
-    T& Splay<T, Key>::find(const Key& key) {
-        typename BST<T, Key>::Node* res = NULL;
+    template<class T, class Key, class Compare, class KeyOf>
+    T& Splay<T, Key, Compare, KeyOf>::find(const Key& key) {
+        typename BST<T, Key, Compare, KeyOf>::Node* res = NULL;
         bool found = this->findRec(key, this->root, &res);
         splay(res);
         assert(this->root == res);
         if (!found) {
-            throw typename BST<T, Key>::KeyNotFound(key);
+            throw typename BST<T, Key, Compare, KeyOf>::KeyNotFound(key);
         }
         return res->data;
     }
 
-    template<class T, class Key>
-    void Splay<T, Key>::insert(const T& data, const Key& key, int value) {
+    template<class T, class Key, class Compare, class KeyOf>
+    void Splay<T, Key, Compare, KeyOf>::insert(const T& data, const Key& key, int value) {
         try {
-            BST<T, Key>::insert(data, key, value);
-        } catch (typename BST<T, Key>::KeyAlreadyExist& e) {
+            BST<T, Key, Compare, KeyOf>::insert(data, key, value);
+        } catch (typename BST<T, Key, Compare, KeyOf>::KeyAlreadyExist& e) {
             this->find(key); //using the Splay find, which will splay it.
             throw e;
         }
         this->find(key); //using the Splay find, which will splay it.
     }
 
-    template<class T, class Key>
-    T Splay<T, Key>::remove(const Key& key) {
+    template<class T, class Key, class Compare, class KeyOf>
+    T Splay<T, Key, Compare, KeyOf>::remove(const Key& key) {
         T saved_data = this->find(
                 key); //splaying the node we want to delete to the root
-        typename BST<T, Key>::Node* saved_left_son = this->root->left_son;
-        typename BST<T, Key>::Node* saved_right_son = this->root->right_son;
+        typename BST<T, Key, Compare, KeyOf>::Node* saved_left_son = this->root->left_son;
+        typename BST<T, Key, Compare, KeyOf>::Node* saved_right_son = this->root->right_son;
         if (saved_right_son)//severing the right sub-tree from root.
             saved_right_son->parent = NULL;
         if (saved_left_son)//severing the left sub-tree from root.
             saved_left_son->parent = NULL;
         delete this->root;
-        typename BST<T, Key>::Node* new_root = this->findMinRec(saved_right_son);
+        typename BST<T, Key, Compare, KeyOf>::Node* new_root = this->findMinRec(saved_right_son);
         if (new_root == NULL) //no right son at all
             this->root = saved_left_son;
         else { //new_root is the min of the right son sub-tree
@@ -189,7 +210,7 @@ namespace trees {
             this->root = new_root;
             //update ranks
             if (this->root->right_son) {
-                typename BST<T, Key>::Node* update_start_node = this->findMinRec(
+                typename BST<T, Key, Compare, KeyOf>::Node* update_start_node = this->findMinRec(
                         this->root->right_son);
                 this->update_ranks_to_the_top(update_start_node);
             } else {
@@ -197,44 +218,79 @@ namespace trees {
             }
         }
         this->size--;
+        this->version++;
         return saved_data;
     }
 
-    template<class T, class Key>
-    T Splay<T, Key>::findMin() {
-        typename BST<T, Key>::Node* result = this->findMinRec(this->root);
+    template<class T, class Key, class Compare, class KeyOf>
+    void Splay<T, Key, Compare, KeyOf>::update(const Key& key, const T& data, int value) {
+        this->find(key); //splaying the node to the root
+        this->root->data = data;
+        this->root->value = value;
+        this->update_ranks(this->root);
+        this->version++;
+    }
+
+    template<class T, class Key, class Compare, class KeyOf>
+    T Splay<T, Key, Compare, KeyOf>::findMin() {
+        typename BST<T, Key, Compare, KeyOf>::Node* result = this->findMinRec(this->root);
         if (result) {
             splay(result);
             return result->data;
         }
-        throw typename BST<T, Key>::TreeIsEmpty();
+        throw typename BST<T, Key, Compare, KeyOf>::TreeIsEmpty();
     }
 
-    template<class T, class Key>
-    T Splay<T, Key>::findMax() {
-        typename BST<T, Key>::Node* result = this->findMaxRec(this->root);
+    template<class T, class Key, class Compare, class KeyOf>
+    T Splay<T, Key, Compare, KeyOf>::findMax() {
+        typename BST<T, Key, Compare, KeyOf>::Node* result = this->findMaxRec(this->root);
         if (result) {
             splay(result);
             return result->data;
         }
-        throw typename BST<T, Key>::TreeIsEmpty();
+        throw typename BST<T, Key, Compare, KeyOf>::TreeIsEmpty();
     }
 
-    template<class T, class Key>
-    Key Splay<T, Key>::select(int k) {
-        Key result = BST<T, Key>::select(k);
+    template<class T, class Key, class Compare, class KeyOf>
+    Key Splay<T, Key, Compare, KeyOf>::select(int k) {
+        Key result = BST<T, Key, Compare, KeyOf>::select(k);
         find(result);
         return result;
     }
 
-    template<class T, class Key>
-    int Splay<T, Key>::rank_weight(Key x) {
+    template<class T, class Key, class Compare, class KeyOf>
+    long long Splay<T, Key, Compare, KeyOf>::rank_weight(Key x) {
         this->find(x); //will splay x to the root
-        int result = this->root->value;
+        long long result = this->root->value;
         if (this->root->left_son)
             result += this->root->left_son->weight;
         return result;
     }
 
+    template<class T, class Key, class Compare, class KeyOf>
+    int Splay<T, Key, Compare, KeyOf>::rank(Key x) {
+        this->find(x); //will splay x to the root
+        int result = 1;
+        if (this->root->left_son)
+            result += this->root->left_son->size_of_sub_tree;
+        return result;
+    }
+
+    template<class T, class Key, class Compare, class KeyOf>
+    long long Splay<T, Key, Compare, KeyOf>::prefixWeight(int k) {
+        if (k < 0 || k > this->size)
+            throw typename BST<T, Key, Compare, KeyOf>::InvalidInput();
+        long long sum;
+        splay(this->descendPrefix(k, &sum));
+        return sum;
+    }
+
+    template<class T, class Key, class Compare, class KeyOf>
+    int Splay<T, Key, Compare, KeyOf>::countLess(const Key& key) {
+        int count;
+        splay(this->descendCountLess(key, &count));
+        return count;
+    }
+
 }/*namespace end*/
 #endif //WET_SPLAYTREE_H
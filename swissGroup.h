@@ -0,0 +1,205 @@
+#ifndef DSWET2_SWISSGROUP_H
+#define DSWET2_SWISSGROUP_H
+
+/**---------------------------SWISS GROUP----------------------------------
+ * Control byte primitives for open addressing tables in the Swiss-table
+ * style. Every slot of a table has one control byte:
+ *      EMPTY   (0x80) - the slot was never used since the last rehash
+ *      DELETED (0xFE) - the slot's entry was removed (tombstone)
+ *      0..127         - the slot is full, the byte is the entry's 7 bit tag
+ * The control bytes are matched a whole probe group at a time, so one probe
+ * checks SWISS_GROUP_WIDTH slots before any entry is touched.
+ * The implementation is picked at compile time:
+ *      AVX2     - 32 slots per group
+ *      SSE2     - 16 slots per group
+ *      portable -  8 slots per group, matched with 64 bit arithmetic
+ * Define SWISS_PORTABLE to force the portable implementation. */
+
+#if defined(__AVX2__) && !defined(SWISS_PORTABLE)
+#include <immintrin.h>
+#define SWISS_GROUP_WIDTH 32
+#define SWISS_AVX2
+#elif defined(__SSE2__) && !defined(SWISS_PORTABLE)
+#include <emmintrin.h>
+#define SWISS_GROUP_WIDTH 16
+#define SWISS_SSE2
+#else
+#define SWISS_GROUP_WIDTH 8
+#endif
+
+namespace swiss {
+
+    const signed char EMPTY = -128;
+    const signed char DELETED = -2;
+
+    /**MIX
+     * spreads the bits of x over the whole word (murmur3 finalizer), so
+     * both the position bits and the tag bits depend on every bit of x */
+    inline unsigned int mix(int x) {
+        unsigned int h = (unsigned int) x;
+        h ^= h >> 16;
+        h *= 0x85ebca6bu;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35u;
+        h ^= h >> 16;
+        return h;
+    }
+
+    /**H1 - the part of the hash that picks the first probe group */
+    inline unsigned int h1(unsigned int hash) {
+        return hash >> 7;
+    }
+
+    /**H2 - the 7 bit tag kept in the control byte */
+    inline signed char h2(unsigned int hash) {
+        return (signed char) (hash & 0x7F);
+    }
+
+    inline bool isFull(signed char ctrl) {
+        return ctrl >= 0;
+    }
+
+    /**BIT MASK
+     * the slots of a group that matched. Each slot is one bit (SIMD) or
+     * the top bit of one byte (portable), iterate with next() */
+    class BitMask {
+        unsigned long long bits;
+
+    public:
+        BitMask() : bits(0) {}
+
+        explicit BitMask(unsigned long long bits) : bits(bits) {}
+
+        bool any() const {
+            return bits != 0;
+        }
+
+        /**NEXT
+         * @return the index in the group of the lowest matched slot, and
+         *         removes it from the mask. The mask must not be empty */
+        int next() {
+            int index = __builtin_ctzll(bits);
+            bits &= bits - 1;
+#if SWISS_GROUP_WIDTH == 8
+            return index >> 3;
+#else
+            return index;
+#endif
+        }
+    };
+
+    /**PROBE GROUP
+     * SWISS_GROUP_WIDTH control bytes loaded from ctrl */
+    class ProbeGroup {
+#if defined(SWISS_AVX2)
+        __m256i ctrl;
+#elif defined(SWISS_SSE2)
+        __m128i ctrl;
+#else
+        unsigned long long ctrl;
+        static const unsigned long long LSBS = 0x0101010101010101ull;
+        static const unsigned long long MSBS = 0x8080808080808080ull;
+#endif
+
+    public:
+        explicit ProbeGroup(const signed char* position) {
+#if defined(SWISS_AVX2)
+            ctrl = _mm256_loadu_si256((const __m256i*) position);
+#elif defined(SWISS_SSE2)
+            ctrl = _mm_loadu_si128((const __m128i*) position);
+#else
+            ctrl = 0;
+            for (int i = 0; i < 8; i++)
+                ctrl |= (unsigned long long) (unsigned char) position[i]
+                        << (8 * i);
+#endif
+        }
+
+        /**MATCH
+         * @return the full slots tagged with tag. The portable version may
+         *         report false positives, the keys are compared anyway */
+        BitMask match(signed char tag) const {
+#if defined(SWISS_AVX2)
+            return BitMask((unsigned int) _mm256_movemask_epi8(
+                    _mm256_cmpeq_epi8(_mm256_set1_epi8(tag), ctrl)));
+#elif defined(SWISS_SSE2)
+            return BitMask((unsigned int) _mm_movemask_epi8(
+                    _mm_cmpeq_epi8(_mm_set1_epi8(tag), ctrl)));
+#else
+            unsigned long long x = ctrl ^ (LSBS * (unsigned char) tag);
+            return BitMask((x - LSBS) & ~x & MSBS);
+#endif
+        }
+
+        /**MATCH EMPTY
+         * @return the EMPTY slots */
+        BitMask matchEmpty() const {
+#if defined(SWISS_AVX2)
+            return BitMask((unsigned int) _mm256_movemask_epi8(
+                    _mm256_cmpeq_epi8(_mm256_set1_epi8(EMPTY), ctrl)));
+#elif defined(SWISS_SSE2)
+            return BitMask((unsigned int) _mm_movemask_epi8(
+                    _mm_cmpeq_epi8(_mm_set1_epi8(EMPTY), ctrl)));
+#else
+            //EMPTY is the only special byte with bit 1 clear
+            return BitMask(ctrl & ~(ctrl << 6) & MSBS);
+#endif
+        }
+
+        /**MATCH FULL
+         * @return the slots that hold an entry (top bit clear) */
+        BitMask matchFull() const {
+#if defined(SWISS_AVX2)
+            return BitMask(~(unsigned int) _mm256_movemask_epi8(ctrl));
+#elif defined(SWISS_SSE2)
+            return BitMask(~(unsigned int) _mm_movemask_epi8(ctrl) & 0xFFFFu);
+#else
+            return BitMask(~ctrl & MSBS);
+#endif
+        }
+
+        /**MATCH EMPTY OR DELETED
+         * @return the slots that can take a new entry (top bit set) */
+        BitMask matchEmptyOrDeleted() const {
+#if defined(SWISS_AVX2)
+            return BitMask((unsigned int) _mm256_movemask_epi8(ctrl));
+#elif defined(SWISS_SSE2)
+            return BitMask((unsigned int) _mm_movemask_epi8(ctrl));
+#else
+            return BitMask(ctrl & MSBS);
+#endif
+        }
+    };
+
+    /**PROBE SEQUENCE
+     * triangular probing over the groups of a table with a power of 2
+     * number of groups, visits every group exactly once */
+    class ProbeSequence {
+        unsigned int mask;
+        unsigned int group;
+        unsigned int step;
+
+    public:
+        /**@param hash - the mixed hash of the key
+         * @param num_of_groups - a power of 2 */
+        ProbeSequence(unsigned int hash, unsigned int num_of_groups) :
+                mask(num_of_groups - 1), group(h1(hash) & mask), step(0) {}
+
+        /**@return the index of the first slot of the current group */
+        int offset() const {
+            return (int) (group * SWISS_GROUP_WIDTH);
+        }
+
+        void next() {
+            step++;
+            group = (group + step) & mask;
+        }
+
+        /**@return how many groups were probed before the current one */
+        int index() const {
+            return (int) step;
+        }
+    };
+}
+
+#endif //DSWET2_SWISSGROUP_H
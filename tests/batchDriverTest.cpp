@@ -0,0 +1,274 @@
+#include "../BatchDriver.h"
+
+#include "testUtility.h"
+#include <cassert>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/**runs input through a driver of colosseum and returns what it wrote. A
+ * malformed input is rethrown after the output is read */
+std::string runDriver(Colosseum& colosseum, const char* input, size_t length,
+                      BatchDriver::Statistics* statistics = NULL) {
+    FILE* output = tmpfile();
+    assert(output);
+    BatchDriver* driver = new BatchDriver(colosseum, fileno(output));
+    bool malformed = false;
+    long long position = -1;
+    try {
+        driver->run(input, length);
+    } catch (BatchDriver::InvalidFormat& e) {
+        malformed = true;
+        position = e.getPosition();
+    }
+    driver->flush();
+    if (statistics)
+        *statistics = driver->getStatistics();
+    delete driver;
+    std::string result;
+    rewind(output);
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), output)) > 0)
+        result.append(buffer, n);
+    fclose(output);
+    if (malformed)
+        throw BatchDriver::InvalidFormat(position);
+    return result;
+}
+
+std::string runText(Colosseum& colosseum, const char* input) {
+    return runDriver(colosseum, input, strlen(input));
+}
+
+void testText() {
+    Colosseum colosseum;
+    const char* input =
+            "# groups\n"
+            "G 1\n"
+            "G 2\n"
+            "G 1\n"
+            "G -3\n"
+            "\n"
+            "A 10 50 1\n"
+            "A 11 20 1\n"
+            "A 20 40 2\t\n"
+            "  A   21 31 2\r\n"
+            "A 10 5 2\n"
+            "A 30 5 9\n"
+            "T 2\n"
+            "S 1\n"
+            "K 21\n"
+            "W\n"
+            "U 11 100\n"
+            "S 1\n"
+            "R 20\n"
+            "R 20\n"
+            "M 2 1\n"
+            "T 3\n"
+            "X 2\n"
+            "T 1";
+    const char* expected =
+            "SUCCESS\n"
+            "SUCCESS\n"
+            "FAILURE\n"
+            "INVALID_INPUT\n"
+            "SUCCESS\n"
+            "SUCCESS\n"
+            "SUCCESS\n"
+            "SUCCESS\n"
+            "FAILURE\n"
+            "FAILURE\n"
+            "90\n"
+            "10\n"
+            "3\n"
+            "1\n"
+            "SUCCESS\n"
+            "11\n"
+            "SUCCESS\n"
+            "FAILURE\n"
+            "SUCCESS\n"
+            "181\n"
+            "SUCCESS\n"
+            "INVALID_INPUT\n";
+    BatchDriver::Statistics statistics;
+    ASSERT_EQUALS(std::string(expected),
+                  runDriver(colosseum, input, strlen(input), &statistics));
+    ASSERT_EQUALS(22, statistics.operations);
+    ASSERT_EQUALS(7, statistics.queries);
+    ASSERT_EQUALS(6, statistics.failed);
+    ASSERT_EQUALS((long long) strlen(input), statistics.bytes_read);
+    ASSERT_EQUALS((long long) strlen(expected), statistics.bytes_written);
+    ASSERT_EQUALS(0, colosseum.getNumOfGroups());
+}
+
+void testFights() {
+    Colosseum colosseum;
+    runText(colosseum, "G 1\nG 2\nG 3\n"
+                       "A 10 50 1\nA 11 20 1\n"
+                       "A 20 40 2\nA 21 31 2\n"
+                       "A 30 35 3\nA 31 35 3\n");
+    //a run of valid fights goes through fightMany
+    ASSERT_EQUALS(std::string("2\n1\n1\n2\n"),
+                  runText(colosseum, "F 1 2 2\nF 1 2 1\nF 1 3 1\nF 3 2 2\n"));
+    //an invalid fight in the run gets its own status, the others still run
+    ASSERT_EQUALS(std::string("2\nINVALID_INPUT\nFAILURE\nINVALID_INPUT\n"
+                              "SUCCESS\n1\n"),
+                  runText(colosseum, "F 1 2 2\nF 1 1 1\nF 1 9 1\nF 1 2 3\n"
+                                     "U 30 1\nF 3 1 1\n"));
+    //more fights than a run holds
+    std::string input;
+    std::string expected;
+    for (int i = 0; i < BATCH_MAX_FIGHT_RUN * 2 + 3; i++) {
+        input += "F 2 1 2\n";
+        expected += "2\n";
+    }
+    ASSERT_EQUALS(expected, runText(colosseum, input.c_str()));
+}
+
+void testMalformedText() {
+    const char* inputs[] = {"G\n", "G 1 2\n", "Q 1\n", "G1\n", "G 1x\n",
+                            "G 2147483648\n", "A 1 - 1\n", "G 1,\n"};
+    for (int i = 0; i < (int) (sizeof(inputs) / sizeof(inputs[0])); i++) {
+        Colosseum colosseum;
+        ASSERT_THROWS(BatchDriver::InvalidFormat,
+                      runText(colosseum, inputs[i]));
+    }
+    Colosseum colosseum;
+    ASSERT_EQUALS(std::string("INVALID_INPUT\nSUCCESS\n"),
+                  runText(colosseum, "G -2147483648\nG 2147483647\n"
+                                     "# a comment\n"));
+    //the operations before the malformed line run, fights included
+    try {
+        runText(colosseum, "A 1 10 2147483647\nG 5\n\nA 2 3 5\n"
+                           "F 5 2147483647 1\nT x\nG 6\n");
+        ASSERT_TRUE(false);
+    } catch (BatchDriver::InvalidFormat& e) {
+        ASSERT_EQUALS(6, e.getPosition());
+    }
+    ASSERT_EQUALS(2, colosseum.getNumOfGladiators());
+    ASSERT_EQUALS(2, colosseum.getNumOfGroups());
+}
+
+/**builds a binary input of the records */
+std::vector<char> makeBinary(const BatchDriver::BinaryRecord* records,
+                             int n) {
+    BatchDriver::BinaryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "DSWOPS", 6);
+    header.version = BatchDriver::BINARY_VERSION;
+    header.byte_order = BatchDriver::BYTE_ORDER_MARK;
+    std::vector<char> result(sizeof(header) + n * sizeof(*records));
+    memcpy(&result[0], &header, sizeof(header));
+    memcpy(&result[sizeof(header)], records, n * sizeof(*records));
+    return result;
+}
+
+void testBinary() {
+    BatchDriver::BinaryRecord records[] = {
+            {'G', {1, 0, 0}},
+            {'G', {2, 0, 0}},
+            {'A', {10, 50, 1}},
+            {'A', {20, 40, 2}},
+            {'F', {1, 2, 1}},
+            {'F', {1, 2, 2}},
+            {'T', {2, 0, 0}},
+            {'K', {20, 0, 0}},
+    };
+    std::vector<char> input = makeBinary(records, 8);
+    Colosseum colosseum;
+    ASSERT_EQUALS(std::string("SUCCESS\nSUCCESS\nSUCCESS\nSUCCESS\n1\n"
+                              "INVALID_INPUT\n90\n2\n"),
+                  runDriver(colosseum, &input[0], input.size()));
+
+    //the same operations as text give the same results
+    Colosseum text;
+    ASSERT_EQUALS(std::string("SUCCESS\nSUCCESS\nSUCCESS\nSUCCESS\n1\n"
+                              "INVALID_INPUT\n90\n2\n"),
+                  runText(text, "G 1\nG 2\nA 10 50 1\nA 20 40 2\nF 1 2 1\n"
+                                "F 1 2 2\nT 2\nK 20\n"));
+}
+
+void testMalformedBinary() {
+    BatchDriver::BinaryRecord records[] = {
+            {'G', {1, 0, 0}},
+            {'Q', {2, 0, 0}},
+            {'G', {3, 0, 0}},
+    };
+    std::vector<char> input = makeBinary(records, 3);
+    Colosseum colosseum;
+    try {
+        runDriver(colosseum, &input[0], input.size());
+        ASSERT_TRUE(false);
+    } catch (BatchDriver::InvalidFormat& e) {
+        ASSERT_EQUALS(2, e.getPosition());
+    }
+    ASSERT_EQUALS(1, colosseum.getNumOfGroups());
+
+    //a truncated record
+    records[1].operation = 'G' + 256;
+    input = makeBinary(records, 1);
+    input.resize(input.size() + 4);
+    try {
+        runDriver(colosseum, &input[0], input.size());
+        ASSERT_TRUE(false);
+    } catch (BatchDriver::InvalidFormat& e) {
+        ASSERT_EQUALS(2, e.getPosition());
+    }
+    //an operation that isn't a char
+    input = makeBinary(records + 1, 1);
+    ASSERT_THROWS(BatchDriver::InvalidFormat,
+                  runDriver(colosseum, &input[0], input.size()));
+
+    //a bad header
+    input = makeBinary(records, 1);
+    BatchDriver::BinaryHeader header;
+    memcpy(&header, &input[0], sizeof(header));
+    header.version++;
+    memcpy(&input[0], &header, sizeof(header));
+    try {
+        runDriver(colosseum, &input[0], input.size());
+        ASSERT_TRUE(false);
+    } catch (BatchDriver::InvalidFormat& e) {
+        ASSERT_EQUALS(0, e.getPosition());
+    }
+    Colosseum empty;
+    input = makeBinary(records, 0);
+    ASSERT_EQUALS(std::string(""),
+                  runDriver(empty, &input[0], input.size()));
+    ASSERT_THROWS(BatchDriver::InvalidFormat,
+                  runDriver(empty, &input[0], input.size() - 1));
+}
+
+void testLargeOutput() {
+    //more output than the buffer holds
+    Colosseum colosseum;
+    std::string input = "G 1\nA 1000000000 2000000000 1\n"
+                        "A 1000000001 2000000000 1\n";
+    std::string expected = "SUCCESS\nSUCCESS\nSUCCESS\n";
+    for (int i = 0; i < BATCH_OUTPUT_BUFFER_SIZE / 8; i++) {
+        input += "T 2\nS 2\n";
+        expected += "4000000000\n1000000001\n";
+    }
+    ASSERT_EQUALS(expected, runText(colosseum, input.c_str()));
+}
+
+void testBadOutput() {
+    Colosseum colosseum;
+    BatchDriver driver(colosseum, -1);
+    driver.run("G 1\n", 4);
+    ASSERT_THROWS(BatchDriver::IOError, driver.flush());
+    ASSERT_NO_THROW(driver.flush());
+}
+
+int main() {
+    RUN_TEST(testText);
+    RUN_TEST(testFights);
+    RUN_TEST(testMalformedText);
+    RUN_TEST(testBinary);
+    RUN_TEST(testMalformedBinary);
+    RUN_TEST(testLargeOutput);
+    RUN_TEST(testBadOutput);
+    return 0;
+}
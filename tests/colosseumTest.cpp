@@ -0,0 +1,282 @@
+#include "../Colosseum.h"
+
+#include "testUtility.h"
+#include <cassert>
+
+void testGroups() {
+    Colosseum colosseum;
+    ASSERT_EQUALS(0, colosseum.getNumOfGroups());
+    colosseum.addGroup(1);
+    colosseum.addGroup(2);
+    ASSERT_THROWS(Colosseum::KeyAlreadyExist, colosseum.addGroup(1));
+    ASSERT_THROWS(Colosseum::InvalidInput, colosseum.addGroup(-1));
+    ASSERT_EQUALS(2, colosseum.getNumOfGroups());
+    ASSERT_EQUALS(2, colosseum.getGroup(2).getID());
+    ASSERT_THROWS(Colosseum::KeyNotFound, colosseum.getGroup(3));
+    colosseum.removeGroup(2);
+    ASSERT_THROWS(Colosseum::KeyNotFound, colosseum.removeGroup(2));
+    ASSERT_EQUALS(1, colosseum.getNumOfGroups());
+}
+
+void testGladiators() {
+    Colosseum colosseum;
+    colosseum.addGroup(1);
+    colosseum.addGroup(2);
+    colosseum.addGladiator(10, 50, 1);
+    colosseum.addGladiator(20, 30, 2);
+    colosseum.addGladiator(21, 40, 2);
+    ASSERT_EQUALS(3, colosseum.getNumOfGladiators());
+    ASSERT_EQUALS(2, colosseum.getGroupOf(21));
+    ASSERT_EQUALS(50, colosseum.getScore(10));
+    ASSERT_THROWS(Colosseum::KeyAlreadyExist, colosseum.addGladiator(10, 1, 2));
+    ASSERT_THROWS(Colosseum::KeyNotFound, colosseum.addGladiator(11, 1, 3));
+    ASSERT_THROWS(Colosseum::InvalidInput, colosseum.addGladiator(11, -1, 1));
+    ASSERT_THROWS(Colosseum::KeyNotFound, colosseum.getGroupOf(11));
+
+    colosseum.updateScore(20, 60);
+    ASSERT_EQUALS(60, colosseum.getScore(20));
+    ASSERT_EQUALS(60, colosseum.getGroup(2).getScore(20));
+    ASSERT_EQUALS(100, colosseum.getGroup(2).sumOfTopK(2));
+    ASSERT_THROWS(Colosseum::InvalidInput, colosseum.updateScore(20, -1));
+    ASSERT_THROWS(Colosseum::KeyNotFound, colosseum.updateScore(30, 1));
+
+    colosseum.removeGladiator(20);
+    ASSERT_THROWS(Colosseum::KeyNotFound, colosseum.getScore(20));
+    ASSERT_THROWS(Colosseum::KeyNotFound, colosseum.removeGladiator(20));
+    ASSERT_EQUALS(1, colosseum.getGroup(2).getNumOfGladiators());
+
+    //removing a group takes its gladiators out of the index
+    colosseum.removeGroup(2);
+    ASSERT_THROWS(Colosseum::KeyNotFound, colosseum.getGroupOf(21));
+    ASSERT_EQUALS(1, colosseum.getNumOfGladiators());
+    ASSERT_NO_THROW(colosseum.addGladiator(21, 5, 1));
+}
+
+void testThroughGroup() {
+    Colosseum colosseum;
+    colosseum.addGroup(1);
+    colosseum.addGroup(2);
+    Group& group = colosseum.getGroup(1);
+    group.addGladiator(7, 70);
+    ASSERT_EQUALS(1, colosseum.getGroupOf(7));
+    group.updateScore(7, 75);
+    ASSERT_EQUALS(75, colosseum.getScore(7));
+
+    //the index rejects a gladiator of another group, the group undoes it
+    ASSERT_THROWS(GladiatorIndex::KeyAlreadyExist,
+                  colosseum.getGroup(2).addGladiator(7, 1));
+    ASSERT_EQUALS(0, colosseum.getGroup(2).getNumOfGladiators());
+    group.removeGladiator(7);
+    ASSERT_EQUALS(0, colosseum.getNumOfGladiators());
+}
+
+void testAbsorb() {
+    Colosseum colosseum;
+    for (int id = 1; id <= 3; id++)
+        colosseum.addGroup(id);
+    for (int i = 0; i < 30; i++)
+        colosseum.addGladiator(i, i, i % 3 + 1);
+    colosseum.absorb(1, 2);
+    colosseum.absorb(3, 1);
+    ASSERT_EQUALS(1, colosseum.getNumOfGroups());
+    for (int i = 0; i < 30; i++)
+        ASSERT_EQUALS(3, colosseum.getGroupOf(i));
+    //a gladiator of an absorbed group is still located in O(1)
+    colosseum.updateScore(4, 100);
+    ASSERT_EQUALS(100, colosseum.getGroup(2).sumOfTopK(1));
+    colosseum.removeGladiator(5);
+    ASSERT_EQUALS(29, colosseum.getGroup(1).getNumOfGladiators());
+    ASSERT_THROWS(Colosseum::KeyAlreadyExist, colosseum.addGroup(2));
+    colosseum.removeGroup(2);
+    ASSERT_EQUALS(0, colosseum.getNumOfGladiators());
+    ASSERT_EQUALS(0, colosseum.getNumOfGroups());
+}
+
+void testLeaderboard() {
+    Colosseum colosseum;
+    colosseum.addGroup(1);
+    colosseum.addGroup(2);
+    colosseum.addGladiator(1, 50, 1);
+    colosseum.addGladiator(2, 70, 2);
+    colosseum.addGladiator(3, 50, 2);
+    colosseum.addGladiator(4, 10, 1);
+    //70(2) 50(1) 50(3) 10(4)
+    ASSERT_EQUALS(2, colosseum.select(1));
+    ASSERT_EQUALS(1, colosseum.select(2));
+    ASSERT_EQUALS(3, colosseum.select(3));
+    ASSERT_EQUALS(3, colosseum.rank(3));
+    ASSERT_EQUALS(4, colosseum.rank(4));
+    ASSERT_EQUALS(170, colosseum.topKWeight(3));
+    ASSERT_EQUALS(0, colosseum.topKWeight(0));
+    ASSERT_THROWS(Colosseum::InvalidInput, colosseum.select(5));
+    ASSERT_THROWS(Colosseum::InvalidInput, colosseum.topKWeight(5));
+    ASSERT_THROWS(Colosseum::KeyNotFound, colosseum.rank(5));
+
+    //changes through the colosseum and through the groups
+    colosseum.updateScore(4, 80);
+    colosseum.getGroup(2).updateScore(2, 5);
+    ASSERT_EQUALS(4, colosseum.select(1));
+    ASSERT_EQUALS(4, colosseum.rank(2));
+    colosseum.getGroup(1).removeGladiator(1);
+    ASSERT_EQUALS(2, colosseum.rank(3));
+    ASSERT_EQUALS(135, colosseum.topKWeight(3));
+    colosseum.absorb(1, 2);
+    ASSERT_EQUALS(135, colosseum.topKWeight(3));
+    colosseum.removeGroup(2);
+    ASSERT_THROWS(Colosseum::InvalidInput, colosseum.select(1));
+}
+
+void testLeaderboardAgainstScan() {
+    Colosseum colosseum;
+    const int num_of_groups = 5;
+    const int max_id = 300;
+    int scores[max_id];
+    for (int id = 0; id < num_of_groups; id++)
+        colosseum.addGroup(id);
+    for (int i = 0; i < max_id; i++)
+        scores[i] = -1; //not in the colosseum
+    unsigned int seed = 11;
+    for (int op = 0; op < 4000; op++) {
+        seed = seed * 1103515245u + 12345u;
+        int id = (int) ((seed >> 16) % max_id);
+        int score = (int) ((seed >> 6) % 40);
+        if (scores[id] < 0) {
+            colosseum.addGladiator(id, score, (int) (seed % num_of_groups));
+            scores[id] = score;
+        } else if (op % 4 == 0) {
+            colosseum.removeGladiator(id);
+            scores[id] = -1;
+        } else {
+            colosseum.updateScore(id, score);
+            scores[id] = score;
+        }
+        if (scores[id] < 0)
+            continue;
+        //position of id: better scores, and equal scores with lower ids
+        int position = 1;
+        for (int i = 0; i < max_id; i++) {
+            if (scores[i] > scores[id] || (scores[i] == scores[id] && i < id))
+                position++;
+        }
+        ASSERT_EQUALS(position, colosseum.rank(id));
+        ASSERT_EQUALS(id, colosseum.select(position));
+    }
+    long long total = 0;
+    for (int i = 0; i < max_id; i++)
+        total += scores[i] >= 0 ? scores[i] : 0;
+    ASSERT_EQUALS(total,
+                  colosseum.topKWeight(colosseum.getNumOfGladiators()));
+}
+
+void testFight() {
+    Colosseum colosseum;
+    colosseum.addGroup(1);
+    colosseum.addGroup(2);
+    colosseum.addGroup(3);
+    colosseum.addGladiator(10, 50, 1);
+    colosseum.addGladiator(11, 20, 1);
+    colosseum.addGladiator(12, 1, 1);
+    colosseum.addGladiator(20, 40, 2);
+    colosseum.addGladiator(21, 31, 2);
+    colosseum.addGladiator(30, 60, 3);
+    ASSERT_EQUALS(1, colosseum.fight(1, 2, 1));
+    ASSERT_EQUALS(1, colosseum.fight(2, 1, 1));
+    ASSERT_EQUALS(2, colosseum.fight(1, 2, 2));
+    ASSERT_EQUALS(3, colosseum.fight(3, 1, 1));
+    //a tie goes to the lower id
+    colosseum.updateScore(30, 50);
+    ASSERT_EQUALS(1, colosseum.fight(3, 1, 1));
+    ASSERT_THROWS(Colosseum::InvalidInput, colosseum.fight(1, 3, 2));
+    ASSERT_THROWS(Colosseum::InvalidInput, colosseum.fight(1, 2, 0));
+    ASSERT_THROWS(Colosseum::InvalidInput, colosseum.fight(1, 1, 1));
+    ASSERT_THROWS(Colosseum::KeyNotFound, colosseum.fight(1, 4, 1));
+    colosseum.absorb(1, 3);
+    ASSERT_THROWS(Colosseum::InvalidInput, colosseum.fight(1, 3, 1));
+    ASSERT_EQUALS(1, colosseum.fight(2, 1, 2));
+
+    Colosseum::Fight fights[3] = {{1, 2, 2, -1}, {2, 1, 1, -1},
+                                  {1, 2, 5, -1}};
+    ASSERT_THROWS(Colosseum::InvalidInput, colosseum.fightMany(fights, 3));
+    ASSERT_EQUALS(-1, fights[0].winner);
+    ASSERT_NO_THROW(colosseum.fightMany(fights, 2));
+    ASSERT_EQUALS(1, fights[0].winner);
+    ASSERT_EQUALS(1, fights[1].winner);
+}
+
+void testFightMany() {
+    Colosseum colosseum;
+    const int num_of_groups = 40;
+    const int num_of_fights = 3000;
+    unsigned int seed = 5;
+    for (int id = 0; id < num_of_groups; id++) {
+        colosseum.addGroup(id);
+        for (int i = 0; i < 20; i++) {
+            seed = seed * 1103515245u + 12345u;
+            colosseum.addGladiator(id * 100 + i, (int) ((seed >> 16) % 50),
+                                   id);
+        }
+    }
+    Colosseum::Fight* fights = new Colosseum::Fight[num_of_fights];
+    for (int i = 0; i < num_of_fights; i++) {
+        seed = seed * 1103515245u + 12345u;
+        fights[i].group_a = (int) ((seed >> 16) % num_of_groups);
+        fights[i].group_b = (fights[i].group_a + 1 +
+                             (int) ((seed >> 8) % (num_of_groups - 1))) %
+                            num_of_groups;
+        fights[i].k = 1 + (int) (seed % 20);
+        fights[i].winner = -1;
+    }
+    colosseum.fightMany(fights, num_of_fights, 4);
+    for (int i = 0; i < num_of_fights; i++) {
+        ASSERT_EQUALS(colosseum.fight(fights[i].group_a, fights[i].group_b,
+                                      fights[i].k), fights[i].winner);
+    }
+    colosseum.fightMany(fights, num_of_fights);
+    for (int i = 0; i < num_of_fights; i++) {
+        ASSERT_EQUALS(colosseum.fight(fights[i].group_a, fights[i].group_b,
+                                      fights[i].k), fights[i].winner);
+    }
+    delete[] fights;
+}
+
+void testGroupHeaps() {
+    Colosseum colosseum;
+    ASSERT_THROWS(Colosseum::KeyNotFound, colosseum.getWeakestGroup());
+    ASSERT_THROWS(Colosseum::KeyNotFound, colosseum.getLowestGroup());
+    colosseum.addGroup(5);
+    colosseum.addGroup(3);
+    colosseum.addGroup(8);
+    ASSERT_EQUALS(3, colosseum.getWeakestGroup());
+    ASSERT_EQUALS(3, colosseum.getLowestGroup());
+    colosseum.addGladiator(1, 10, 3);
+    colosseum.addGladiator(2, 4, 5);
+    colosseum.addGladiator(3, 7, 8);
+    ASSERT_EQUALS(5, colosseum.getWeakestGroup());
+    colosseum.getGroup(5).updateScore(2, 20);
+    ASSERT_EQUALS(8, colosseum.getWeakestGroup());
+    colosseum.removeGladiator(1);
+    ASSERT_EQUALS(3, colosseum.getWeakestGroup());
+    ASSERT_EQUALS(0, colosseum.getTotalScore(3));
+    colosseum.absorb(8, 3);
+    ASSERT_EQUALS(8, colosseum.getWeakestGroup());
+    ASSERT_EQUALS(5, colosseum.getLowestGroup());
+    colosseum.absorb(8, 5);
+    ASSERT_EQUALS(27, colosseum.getTotalScore(3));
+    ASSERT_EQUALS(8, colosseum.getLowestGroup());
+    colosseum.removeGroup(5);
+    ASSERT_THROWS(Colosseum::KeyNotFound, colosseum.getWeakestGroup());
+    ASSERT_THROWS(Colosseum::KeyNotFound, colosseum.getTotalScore(8));
+}
+
+int main() {
+    RUN_TEST(testGroups);
+    RUN_TEST(testGladiators);
+    RUN_TEST(testThroughGroup);
+    RUN_TEST(testAbsorb);
+    RUN_TEST(testLeaderboard);
+    RUN_TEST(testLeaderboardAgainstScan);
+    RUN_TEST(testFight);
+    RUN_TEST(testFightMany);
+    RUN_TEST(testGroupHeaps);
+    return 0;
+}
@@ -0,0 +1,83 @@
+/**COLUMN SCAN BENCHMARK
+ * sums, takes the maximum of and counts the scores above a threshold of
+ * one group of 10^6 gladiators, 100 times each, by walking the tree nodes
+ * (forEachGladiator) and by reducing the score column (scoreReduce.h).
+ * Build it with and without vector instructions to compare them.
+ * build: g++ -O2 -DNDEBUG columnScanBench.cpp ../Group.cpp ../Gladiator.cpp
+ *        add -mavx2 for AVX2, or -DREDUCE_PORTABLE for scalar reductions
+ * usage: columnScanBench */
+
+#include "../Group.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define NUM_OF_GLADIATORS 1000000
+#define ROUNDS 100
+
+double secondsSince(clock_t start) {
+    return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+/**the three aggregates, one node at a time */
+class Aggregate {
+public:
+    long long sum;
+    int max;
+    int above;
+    int threshold;
+
+    explicit Aggregate(int threshold) : sum(0), max(0), above(0),
+                                        threshold(threshold) {}
+
+    void operator()(const Gladiator& gladiator) {
+        sum += gladiator.getScore();
+        max = gladiator.getScore() > max ? gladiator.getScore() : max;
+        above += gladiator.getScore() > threshold ? 1 : 0;
+    }
+};
+
+int main() {
+#if defined(REDUCE_AVX2)
+    printf("reductions: AVX2\n");
+#elif defined(REDUCE_SSE2)
+    printf("reductions: SSE2\n");
+#else
+    printf("reductions: portable\n");
+#endif
+    Gladiator* gladiators = new Gladiator[NUM_OF_GLADIATORS];
+    unsigned int seed = 12345u;
+    for (int i = 0; i < NUM_OF_GLADIATORS; i++) {
+        seed = seed * 1103515245u + 12345u;
+        gladiators[i] = Gladiator(i, (int) ((seed >> 8) % 100000));
+    }
+    Group group(1);
+    group.loadGladiators(gladiators, NUM_OF_GLADIATORS);
+    delete[] gladiators;
+
+    long long check = 0;
+    clock_t start = clock();
+    for (int round = 0; round < ROUNDS; round++) {
+        Aggregate aggregate(round * 1000);
+        group.forEachGladiator(aggregate);
+        check += aggregate.sum + aggregate.max + aggregate.above;
+    }
+    double tree_time = secondsSince(start);
+
+    group.enableColumns();
+    long long column_check = 0;
+    start = clock();
+    for (int round = 0; round < ROUNDS; round++) {
+        column_check += group.sumOfScores() + group.maxScore() +
+                        group.countAbove(round * 1000);
+    }
+    double column_time = secondsSince(start);
+    if (check != column_check)
+        printf("results differ\n");
+    double bytes = (double) NUM_OF_GLADIATORS * sizeof(int) * 3 * ROUNDS;
+    printf("%14s %10s %10s\n", "", "time (s)", "GB/s");
+    printf("%14s %10.4f %10s\n", "tree walk", tree_time, "-");
+    printf("%14s %10.4f %10.2f\n", "score column", column_time,
+           bytes / column_time / 1e9);
+    return 0;
+}
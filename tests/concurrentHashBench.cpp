@@ -0,0 +1,79 @@
+/**CONCURRENT HASH TABLE BENCHMARK
+ * measures lookup throughput of ConcurrentHashTable for 1..all cores, next
+ * to a HashTable serialized behind a single mutex.
+ * build: g++ -std=c++11 -O2 -DNDEBUG concurrentHashBench.cpp ../HashTable.cpp
+ *        ../Group.cpp ../Gladiator.cpp -lpthread
+ * usage: concurrentHashBench [number_of_groups] [lookups_per_thread] */
+
+#include "../ConcurrentHashTable.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+template<class Lookup>
+double runThreads(int threads, int lookups, int groups, Lookup lookup) {
+    std::vector<std::thread> workers;
+    std::atomic<long> found(0);
+    std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.push_back(std::thread([&, t]() {
+            unsigned int seed = 12345u * (t + 1);
+            long local = 0;
+            for (int i = 0; i < lookups; i++) {
+                seed = seed * 1103515245u + 12345u;
+                if (lookup((int) ((seed >> 8) % (unsigned int) (groups * 2))))
+                    local++;
+            }
+            found += local;
+        }));
+    }
+    for (size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+    std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+    if (found.load() == 0)
+        std::printf("(no hits)\n");
+    return (double) threads * lookups / elapsed.count();
+}
+
+int main(int argc, char** argv) {
+    int groups = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int lookups = argc > 2 ? std::atoi(argv[2]) : 2000000;
+    int cores = (int) std::thread::hardware_concurrency();
+    if (cores <= 0)
+        cores = 1;
+
+    std::vector<int> ids(groups);
+    for (int i = 0; i < groups; i++)
+        ids[i] = i;
+    HashTable serial(&ids[0], groups);
+    std::mutex serial_lock;
+    ConcurrentHashTable concurrent;
+    for (int i = 0; i < groups; i++)
+        concurrent.insert(Group(i));
+
+    std::printf("%d groups, %d lookups per thread (half of them misses)\n",
+                groups, lookups);
+    std::printf("%8s %18s %18s\n", "threads", "mutex ops/s", "striped ops/s");
+    for (int threads = 1; threads <= cores; threads *= 2) {
+        double mutex_rate = runThreads(threads, lookups, groups,
+                                       [&](int id) {
+                                           std::lock_guard<std::mutex> g(
+                                                   serial_lock);
+                                           return serial.contains(id);
+                                       });
+        double striped_rate = runThreads(threads, lookups, groups,
+                                         [&](int id) {
+                                             return concurrent.contains(id);
+                                         });
+        std::printf("%8d %18.0f %18.0f\n", threads, mutex_rate, striped_rate);
+        if (threads < cores && threads * 2 > cores)
+            threads = cores / 2;
+    }
+    return 0;
+}
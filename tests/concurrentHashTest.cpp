@@ -0,0 +1,78 @@
+#include "../ConcurrentHashTable.h"
+
+#include "testUtility.h"
+#include <thread>
+#include <vector>
+
+class CheckID {
+    int expected;
+public:
+    explicit CheckID(int expected) : expected(expected) {}
+
+    void operator()(const Group& group) const {
+        ASSERT_EQUALS(expected, group.getID());
+    }
+};
+
+void testSingleThread() {
+    ConcurrentHashTable hash;
+    hash.insert(Group(1));
+    hash.insert(Group(5));
+    hash.insert(Group(64));
+    ASSERT_THROWS(HashTable::KeyAlreadyExist, hash.insert(Group(5)));
+    ASSERT_EQUALS(3, hash.getSize());
+    ASSERT_TRUE(hash.contains(64));
+    ASSERT_FALSE(hash.contains(2));
+    CheckID check(5);
+    ASSERT_NO_THROW(hash.find(5, check));
+    ASSERT_THROWS(HashTable::KeyNotFound, hash.find(6, check));
+    ASSERT_NO_THROW(hash.remove(5));
+    ASSERT_THROWS(HashTable::KeyNotFound, hash.remove(5));
+    ASSERT_FALSE(hash.contains(5));
+    ASSERT_EQUALS(2, hash.getSize());
+}
+
+void testParallelInsertAndFind() {
+    const int threads = 4;
+    const int per_thread = 2000;
+    ConcurrentHashTable hash;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.push_back(std::thread([&hash, t, per_thread]() {
+            for (int i = 0; i < per_thread; i++)
+                hash.insert(Group(t * per_thread + i));
+        }));
+    }
+    for (size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+    ASSERT_EQUALS(threads * per_thread, hash.getSize());
+
+    //readers run while writers remove the odd ids (and shrink stripes)
+    std::atomic<int> missing(0);
+    workers.clear();
+    for (int t = 0; t < threads; t++) {
+        workers.push_back(std::thread([&hash, &missing, t, per_thread]() {
+            for (int i = 0; i < per_thread; i++) {
+                int id = t * per_thread + i;
+                if (id % 2 == 0 && !hash.contains(id))
+                    missing++;
+            }
+        }));
+        workers.push_back(std::thread([&hash, t, per_thread]() {
+            for (int i = 1; i < per_thread; i += 2)
+                hash.remove(t * per_thread + i);
+        }));
+    }
+    for (size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+    ASSERT_EQUALS(0, missing.load());
+    ASSERT_EQUALS(threads * per_thread / 2, hash.getSize());
+    ASSERT_FALSE(hash.contains(1));
+    ASSERT_TRUE(hash.contains(2));
+}
+
+int main() {
+    RUN_TEST(testSingleThread);
+    RUN_TEST(testParallelInsertAndFind);
+    return 0;
+}
@@ -0,0 +1,52 @@
+/**GROUP ABSORB BENCHMARK
+ * times moving all the gladiators of one group into another of the same
+ * size, with Group::absorb (linear merge of the trees) and with one
+ * removeGladiator + addGladiator per gladiator, for 10^3..10^6 gladiators.
+ * build: g++ -O2 -DNDEBUG groupAbsorbBench.cpp ../Group.cpp ../Gladiator.cpp
+ * usage: groupAbsorbBench */
+
+#include "../Group.h"
+
+#include <stdio.h>
+#include <time.h>
+
+double secondsSince(clock_t start) {
+    return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+/**even ids go to first, odd ids to second, so the trees interleave */
+void fill(Group& first, Group& second, int n) {
+    unsigned int seed = 12345u;
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        first.addGladiator(i * 2, (int) ((seed >> 8) % 100000));
+        second.addGladiator(i * 2 + 1, (int) ((seed >> 12) % 100000));
+    }
+}
+
+int main() {
+    printf("%10s %14s %14s\n", "gladiators", "absorb (s)", "one by one (s)");
+    for (int n = 1000; n <= 1000000; n *= 10) {
+        Group group(1);
+        Group other(2);
+        fill(group, other, n);
+        clock_t start = clock();
+        group.absorb(other);
+        double absorb_time = secondsSince(start);
+
+        Group moved(1);
+        Group source(2);
+        fill(moved, source, n);
+        start = clock();
+        for (int i = 0; i < n; i++) {
+            int score = source.getScore(i * 2 + 1);
+            source.removeGladiator(i * 2 + 1);
+            moved.addGladiator(i * 2 + 1, score);
+        }
+        double one_by_one_time = secondsSince(start);
+        if (group.sumOfTopK(n) != moved.sumOfTopK(n))
+            printf("results differ\n");
+        printf("%10d %14.4f %14.4f\n", n * 2, absorb_time, one_by_one_time);
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "../GroupHeap.h"
+
+#include "testUtility.h"
+
+void testBasic() {
+    GroupHeap heap;
+    ASSERT_THROWS(GroupHeap::Empty, heap.getMin());
+    heap.insert(3, 30);
+    heap.insert(1, 10);
+    heap.insert(2, 10);
+    ASSERT_THROWS(GroupHeap::KeyAlreadyExist, heap.insert(2, 5));
+    ASSERT_EQUALS(1, heap.getMin());
+    heap.decreaseKey(3, 10);
+    ASSERT_EQUALS(1, heap.getMin());
+    heap.decreaseKey(3, 9);
+    ASSERT_EQUALS(3, heap.getMin());
+    ASSERT_THROWS(GroupHeap::InvalidInput, heap.decreaseKey(1, 11));
+    ASSERT_THROWS(GroupHeap::InvalidInput, heap.increaseKey(3, 8));
+    heap.increaseKey(3, 100);
+    ASSERT_EQUALS(1, heap.getMin());
+    heap.remove(1);
+    ASSERT_EQUALS(2, heap.getMin());
+    ASSERT_THROWS(GroupHeap::KeyNotFound, heap.remove(1));
+    ASSERT_THROWS(GroupHeap::KeyNotFound, heap.getKey(1));
+    heap.setKey(2, 200);
+    ASSERT_EQUALS(3, heap.getMin());
+    ASSERT_EQUALS(200, heap.getKey(2));
+    ASSERT_EQUALS(2, heap.getSize());
+    ASSERT_FALSE(heap.contains(1));
+    ASSERT_TRUE(heap.contains(3));
+}
+
+void testAgainstScan() {
+    GroupHeap heap;
+    const int max_id = 500;
+    long long keys[max_id];
+    bool in[max_id];
+    for (int i = 0; i < max_id; i++)
+        in[i] = false;
+    unsigned int seed = 17;
+    for (int op = 0; op < 20000; op++) {
+        seed = seed * 1103515245u + 12345u;
+        int id = (int) ((seed >> 16) % max_id);
+        long long key = (long long) ((seed >> 4) % 1000) - 500;
+        if (!in[id]) {
+            heap.insert(id, key);
+            in[id] = true;
+            keys[id] = key;
+        } else if (op % 3 == 0) {
+            heap.remove(id);
+            in[id] = false;
+        } else {
+            heap.setKey(id, key);
+            keys[id] = key;
+        }
+        int expected = -1;
+        int size = 0;
+        for (int i = 0; i < max_id; i++) {
+            if (!in[i])
+                continue;
+            size++;
+            if (expected < 0 || keys[i] < keys[expected])
+                expected = i;
+        }
+        ASSERT_EQUALS(size, heap.getSize());
+        if (expected >= 0)
+            ASSERT_EQUALS(expected, heap.getMin());
+    }
+    for (int i = 0; i < max_id; i++) {
+        if (in[i])
+            ASSERT_EQUALS(keys[i], heap.getKey(i));
+    }
+}
+
+int main() {
+    RUN_TEST(testBasic);
+    RUN_TEST(testAgainstScan);
+    return 0;
+}
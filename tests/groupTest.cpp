@@ -0,0 +1,510 @@
+#include "../Group.h"
+
+#include "testUtility.h"
+#include <cassert>
+
+/**sums the scores of the k best gladiators the slow way */
+long long topKByScan(const int* scores, int n, int k) {
+    bool* taken = new bool[n];
+    for (int i = 0; i < n; i++)
+        taken[i] = false;
+    long long sum = 0;
+    for (int round = 0; round < k; round++) {
+        int best = -1;
+        for (int i = 0; i < n; i++) {
+            if (!taken[i] && scores[i] >= 0 &&
+                (best == -1 || scores[i] > scores[best]))
+                best = i;
+        }
+        taken[best] = true;
+        sum += scores[best];
+    }
+    delete[] taken;
+    return sum;
+}
+
+void testScoreKey() {
+    int scores[5] = {-2147483647 - 1, -5, 0, 7, 2147483647};
+    int ids[4] = {-2147483647 - 1, 0, 3, 2147483647};
+    for (int i = 0; i < 5; i++) {
+        for (int j = 0; j < 4; j++) {
+            ScoreKey key(scores[i], ids[j]);
+            ASSERT_EQUALS(scores[i], key.getScore());
+            ASSERT_EQUALS(ids[j], key.getId());
+            for (int other = 0; other < 4; other++) {
+                //equal scores by increasing id
+                ASSERT_EQUALS(j < other, key < ScoreKey(scores[i], ids[other]));
+            }
+            for (int other = 0; other < 5; other++) {
+                //higher scores first, whatever the ids
+                if (other == i)
+                    continue;
+                ASSERT_EQUALS(i > other,
+                              key < ScoreKey(scores[other], ids[3 - j]));
+            }
+        }
+    }
+    ASSERT_TRUE(ScoreKey() == ScoreKey(0, 0));
+    ASSERT_TRUE(ScoreKey(1, 2) > ScoreKey(1, 1));
+}
+
+void testAddRemove() {
+    Group group(1);
+    ASSERT_EQUALS(0, group.getNumOfGladiators());
+    ASSERT_EQUALS(0, group.sumOfTopK(0));
+    group.addGladiator(5, 30);
+    group.addGladiator(2, 30);
+    group.addGladiator(9, 10);
+    ASSERT_EQUALS(3, group.getNumOfGladiators());
+    ASSERT_EQUALS(30, group.getScore(2));
+    ASSERT_THROWS(Group::KeyAlreadyExist, group.addGladiator(5, 1));
+    ASSERT_THROWS(Group::InvalidInput, group.addGladiator(-1, 1));
+    ASSERT_THROWS(Group::InvalidInput, group.addGladiator(3, -1));
+    ASSERT_EQUALS(3, group.getNumOfGladiators());
+
+    group.removeGladiator(5);
+    ASSERT_THROWS(Group::KeyNotFound, group.removeGladiator(5));
+    ASSERT_THROWS(Group::KeyNotFound, group.getScore(5));
+    ASSERT_EQUALS(40, group.sumOfTopK(2));
+    ASSERT_EQUALS(1, group.countAbove(10));
+}
+
+void testScoreQueries() {
+    Group group(1);
+    //equal scores coexist, ties go to the lower id
+    group.addGladiator(1, 50);
+    group.addGladiator(2, 20);
+    group.addGladiator(3, 50);
+    group.addGladiator(4, 40);
+    group.addGladiator(5, 20);
+    ASSERT_EQUALS(50, group.sumOfTopK(1));
+    ASSERT_EQUALS(100, group.sumOfTopK(2));
+    ASSERT_EQUALS(140, group.sumOfTopK(3));
+    ASSERT_EQUALS(180, group.sumOfTopK(5));
+    ASSERT_THROWS(Group::InvalidInput, group.sumOfTopK(6));
+    ASSERT_THROWS(Group::InvalidInput, group.sumOfTopK(-1));
+
+    ASSERT_EQUALS(0, group.countAbove(50));
+    ASSERT_EQUALS(2, group.countAbove(49));
+    ASSERT_EQUALS(3, group.countAbove(20));
+    ASSERT_EQUALS(5, group.countAbove(0));
+
+    group.updateScore(2, 60);
+    ASSERT_EQUALS(60, group.getScore(2));
+    ASSERT_EQUALS(60, group.sumOfTopK(1));
+    ASSERT_EQUALS(4, group.countAbove(20));
+    group.updateScore(2, 60);
+    ASSERT_EQUALS(5, group.getNumOfGladiators());
+    ASSERT_THROWS(Group::KeyNotFound, group.updateScore(7, 1));
+    ASSERT_THROWS(Group::InvalidInput, group.updateScore(2, -1));
+}
+
+void testAgainstScan() {
+    Group group(1);
+    int scores[200];
+    for (int i = 0; i < 200; i++)
+        scores[i] = -1; //not in the group
+    unsigned int seed = 7;
+    int n = 0;
+    for (int op = 0; op < 3000; op++) {
+        seed = seed * 1103515245u + 12345u;
+        int id = (int) ((seed >> 16) % 200);
+        int score = (int) ((seed >> 4) % 50);
+        if (scores[id] < 0) {
+            group.addGladiator(id, score);
+            scores[id] = score;
+            n++;
+        } else if (op % 3 == 0) {
+            group.removeGladiator(id);
+            scores[id] = -1;
+            n--;
+        } else {
+            group.updateScore(id, score);
+            scores[id] = score;
+        }
+        int k = (int) ((seed >> 20) % (n + 1));
+        ASSERT_EQUALS(topKByScan(scores, 200, k), group.sumOfTopK(k));
+        int above = 0;
+        for (int i = 0; i < 200; i++)
+            above += scores[i] > score ? 1 : 0;
+        ASSERT_EQUALS(above, group.countAbove(score));
+    }
+    ASSERT_EQUALS(n, group.getNumOfGladiators());
+}
+
+void testLoadAndCopy() {
+    Gladiator sorted[4] = {Gladiator(1, 5), Gladiator(3, 40), Gladiator(6, 5),
+                           Gladiator(8, 15)};
+    Group group(2);
+    group.addGladiator(100, 1);
+    group.loadGladiators(sorted, 4);
+    ASSERT_EQUALS(4, group.getNumOfGladiators());
+    ASSERT_THROWS(Group::KeyNotFound, group.getScore(100));
+    ASSERT_EQUALS(55, group.sumOfTopK(2));
+    ASSERT_EQUALS(2, group.countAbove(5));
+
+    Gladiator negative[1] = {Gladiator(1, -5)};
+    ASSERT_THROWS(Group::InvalidInput, group.loadGladiators(negative, 1));
+    ASSERT_EQUALS(4, group.getNumOfGladiators());
+
+    Group copy(group);
+    copy.removeGladiator(3);
+    ASSERT_EQUALS(40, group.getScore(3));
+    ASSERT_EQUALS(20, copy.sumOfTopK(2));
+    copy = group;
+    ASSERT_EQUALS(55, copy.sumOfTopK(2));
+}
+
+void testAbsorb() {
+    Group group(1);
+    Group other(2);
+    for (int i = 0; i < 50; i++) {
+        if (i % 3 == 0)
+            group.addGladiator(i, i % 7);
+        else
+            other.addGladiator(i, i % 7);
+    }
+    other.absorb(group);
+    ASSERT_EQUALS(0, group.getNumOfGladiators());
+    ASSERT_EQUALS(50, other.getNumOfGladiators());
+    long long sum = 0;
+    for (int i = 0; i < 50; i++)
+        sum += i % 7;
+    ASSERT_EQUALS(sum, other.sumOfTopK(50));
+    ASSERT_EQUALS(6 + 6 + 6 + 6 + 6 + 6 + 6, other.sumOfTopK(7));
+    ASSERT_EQUALS(3, other.getScore(3));
+    ASSERT_NO_THROW(group.addGladiator(3, 1));
+
+    //a shared gladiator changes neither group
+    ASSERT_THROWS(Group::KeyAlreadyExist, other.absorb(group));
+    ASSERT_EQUALS(1, group.getNumOfGladiators());
+    ASSERT_EQUALS(50, other.getNumOfGladiators());
+    ASSERT_EQUALS(1, group.sumOfTopK(1));
+    other.removeGladiator(3);
+    other.absorb(group);
+    ASSERT_EQUALS(1, other.getScore(3));
+    other.absorb(other);
+    ASSERT_EQUALS(50, other.getNumOfGladiators());
+}
+
+class ObserverFailed : public std::exception {
+};
+
+/**counts the changes it is told of, and fails on demand */
+class CountingObserver : public GroupObserver {
+public:
+    int added;
+    int removed;
+    int updated;
+    bool fail;
+
+    CountingObserver() : added(0), removed(0), updated(0), fail(false) {}
+
+    void gladiatorAdded(const Group&, int, int) {
+        if (fail)
+            throw ObserverFailed();
+        added++;
+    }
+
+    void gladiatorRemoved(const Group&, int, int) {
+        removed++;
+    }
+
+    void scoreUpdated(const Group&, int, int, int) {
+        if (fail)
+            throw ObserverFailed();
+        updated++;
+    }
+};
+
+void testObserver() {
+    Group group(1);
+    CountingObserver observer;
+    group.setObserver(&observer);
+    group.addGladiator(1, 10);
+    group.addGladiator(2, 20);
+    group.updateScore(1, 30);
+    group.removeGladiator(2);
+    ASSERT_EQUALS(2, observer.added);
+    ASSERT_EQUALS(1, observer.updated);
+    ASSERT_EQUALS(1, observer.removed);
+
+    //a failing observer leaves the group as it was
+    observer.fail = true;
+    ASSERT_THROWS(ObserverFailed, group.addGladiator(3, 5));
+    ASSERT_THROWS(ObserverFailed, group.updateScore(1, 5));
+    ASSERT_EQUALS(1, group.getNumOfGladiators());
+    ASSERT_EQUALS(30, group.getScore(1));
+    ASSERT_EQUALS(30, group.sumOfTopK(1));
+    ASSERT_EQUALS(0, group.countAbove(30));
+
+    //copies aren't observed
+    Group copy(group);
+    copy.addGladiator(4, 1);
+    ASSERT_EQUALS(2, observer.added);
+}
+
+/**adds GROUP_SMALL_SIZE gladiators of score 0 from id 100 on, so the
+ * group keeps its gladiators in trees */
+void addFiller(Group& group) {
+    for (int i = 0; i < GROUP_SMALL_SIZE; i++)
+        group.addGladiator(100 + i, 0);
+}
+
+void testCache() {
+    Group group(1);
+    addFiller(group);
+    group.addGladiator(1, 50);
+    group.addGladiator(2, 20);
+    group.addGladiator(3, 40);
+    unsigned long version = group.getVersion();
+    ASSERT_EQUALS(90, group.sumOfTopK(2));
+    ASSERT_EQUALS(90, group.sumOfTopK(2));
+    ASSERT_EQUALS(1, group.countAbove(40));
+    ASSERT_EQUALS(1, group.countAbove(40));
+    ASSERT_EQUALS(2, group.getCacheHits());
+    ASSERT_EQUALS(2, group.getCacheMisses());
+    ASSERT_EQUALS(version, group.getVersion());
+
+    //every change invalidates
+    group.updateScore(2, 45);
+    ASSERT_TRUE(version != group.getVersion());
+    ASSERT_EQUALS(95, group.sumOfTopK(2));
+    ASSERT_EQUALS(2, group.countAbove(40));
+    ASSERT_EQUALS(4, group.getCacheMisses());
+    group.removeGladiator(1);
+    ASSERT_EQUALS(85, group.sumOfTopK(2));
+    Group other(2);
+    other.addGladiator(7, 100);
+    group.absorb(other);
+    ASSERT_EQUALS(145, group.sumOfTopK(2));
+    ASSERT_EQUALS(0, other.sumOfTopK(0));
+    Gladiator loaded[GROUP_SMALL_SIZE + 1];
+    loaded[0] = Gladiator(9, 1);
+    for (int i = 0; i < GROUP_SMALL_SIZE; i++)
+        loaded[i + 1] = Gladiator(100 + i, 0);
+    group.loadGladiators(loaded, GROUP_SMALL_SIZE + 1);
+    ASSERT_EQUALS(1, group.sumOfTopK(1));
+    ASSERT_EQUALS(2, group.getCacheHits());
+
+    //older results are replaced once GROUP_CACHE_SIZE are kept
+    for (int score = 0; score <= GROUP_CACHE_SIZE; score++)
+        group.countAbove(score);
+    long long misses = group.getCacheMisses();
+    group.countAbove(0);
+    ASSERT_EQUALS(misses + 1, group.getCacheMisses());
+    group.countAbove(GROUP_CACHE_SIZE);
+    ASSERT_EQUALS(3, group.getCacheHits());
+
+    Group copy(group);
+    ASSERT_EQUALS(0, copy.getCacheHits());
+    ASSERT_EQUALS(1, copy.sumOfTopK(1));
+    copy = other;
+    ASSERT_EQUALS(0, copy.getNumOfGladiators());
+    ASSERT_EQUALS(0, copy.countAbove(GROUP_CACHE_SIZE));
+}
+
+/**collects the ids it is applied on */
+class CollectIds {
+public:
+    int ids[64];
+    int n;
+
+    CollectIds() : n(0) {}
+
+    void operator()(const Gladiator& gladiator) {
+        ids[n++] = gladiator.getId();
+    }
+};
+
+void testSmallGroups() {
+    //ids in a narrow range keep the size around the threshold, so the
+    //group moves between inline and trees over and over
+    const int max_id = 2 * GROUP_SMALL_SIZE + 8;
+    Group group(1);
+    int scores[max_id];
+    for (int i = 0; i < max_id; i++)
+        scores[i] = -1;
+    unsigned int seed = 23;
+    int n = 0;
+    for (int op = 0; op < 4000; op++) {
+        seed = seed * 1103515245u + 12345u;
+        int id = (int) ((seed >> 16) % max_id);
+        int score = (int) ((seed >> 4) % 20);
+        //grows and shrinks in turns, past both thresholds
+        bool shrinking = (op / 500) % 2 == 1;
+        if (scores[id] < 0) {
+            if (shrinking && (seed >> 10) % 8 != 0)
+                continue;
+            group.addGladiator(id, score);
+            scores[id] = score;
+            n++;
+        } else if ((seed >> 10) % 4 < (shrinking ? 3u : 1u)) {
+            group.removeGladiator(id);
+            scores[id] = -1;
+            n--;
+        } else {
+            group.updateScore(id, score);
+            scores[id] = score;
+        }
+        ASSERT_EQUALS(n, group.getNumOfGladiators());
+        for (int k = 0; k <= n; k++)
+            ASSERT_EQUALS(topKByScan(scores, max_id, k), group.sumOfTopK(k));
+        int above = 0;
+        for (int i = 0; i < max_id; i++)
+            above += scores[i] > score ? 1 : 0;
+        ASSERT_EQUALS(above, group.countAbove(score));
+        if (scores[id] >= 0)
+            ASSERT_EQUALS(scores[id], group.getScore(id));
+        CollectIds collect;
+        group.forEachGladiator(collect);
+        ASSERT_EQUALS(n, collect.n);
+        for (int i = 1; i < collect.n; i++)
+            ASSERT_TRUE(collect.ids[i - 1] < collect.ids[i]);
+    }
+}
+
+void testSmallAbsorb() {
+    Group first(1), second(2);
+    first.addGladiator(1, 10);
+    first.addGladiator(3, 30);
+    second.addGladiator(2, 20);
+    second.addGladiator(4, 5);
+    second.addGladiator(3, 1);
+    ASSERT_THROWS(Group::KeyAlreadyExist, first.absorb(second));
+    ASSERT_EQUALS(2, first.getNumOfGladiators());
+    ASSERT_EQUALS(3, second.getNumOfGladiators());
+    second.removeGladiator(3);
+    first.absorb(second);
+    ASSERT_EQUALS(0, second.getNumOfGladiators());
+    ASSERT_EQUALS(4, first.getNumOfGladiators());
+    ASSERT_EQUALS(30, first.sumOfTopK(1));
+    ASSERT_EQUALS(65, first.sumOfTopK(4));
+    ASSERT_EQUALS(2, first.countAbove(10));
+
+    //together past the threshold, absorbed into trees
+    for (int i = 0; i < GROUP_SMALL_SIZE; i++)
+        second.addGladiator(100 + i, 1);
+    first.absorb(second);
+    ASSERT_EQUALS(GROUP_SMALL_SIZE + 4, first.getNumOfGladiators());
+    ASSERT_EQUALS(65 + GROUP_SMALL_SIZE, first.sumOfTopK(GROUP_SMALL_SIZE + 4));
+    ASSERT_EQUALS(0, second.getNumOfGladiators());
+    second.addGladiator(7, 7);
+    ASSERT_EQUALS(7, second.sumOfTopK(1));
+    for (int i = 0; i < GROUP_SMALL_SIZE; i++)
+        first.removeGladiator(100 + i);
+    ASSERT_EQUALS(65, first.sumOfTopK(4));
+    first.absorb(second);
+    ASSERT_EQUALS(72, first.sumOfTopK(5));
+    ASSERT_EQUALS(7, first.getScore(7));
+}
+
+/**checks the columns of group hold exactly the gladiators of scores */
+bool columnsMatch(const Group& group, const int* scores, int max_id) {
+    const int* ids = group.getColumnIds();
+    const int* column_scores = group.getColumnScores();
+    if (ids == NULL || column_scores == NULL)
+        return false;
+    int index = 0;
+    for (int id = 0; id < max_id; id++) {
+        if (scores[id] < 0)
+            continue;
+        if (index == group.getNumOfGladiators() || ids[index] != id ||
+            column_scores[index] != scores[id])
+            return false;
+        index++;
+    }
+    return index == group.getNumOfGladiators();
+}
+
+void testColumns() {
+    const int max_id = 3 * GROUP_SMALL_SIZE;
+    Group with(1), without(2);
+    with.enableColumns();
+    ASSERT_TRUE(with.hasColumns());
+    ASSERT_FALSE(without.hasColumns());
+    ASSERT_TRUE(without.getColumnIds() == NULL);
+    ASSERT_THROWS(Group::KeyNotFound, with.minScore());
+    ASSERT_THROWS(Group::KeyNotFound, without.maxScore());
+    ASSERT_EQUALS(0, with.sumOfScores());
+    int scores[max_id];
+    for (int i = 0; i < max_id; i++)
+        scores[i] = -1;
+    unsigned int seed = 31;
+    for (int op = 0; op < 3000; op++) {
+        seed = seed * 1103515245u + 12345u;
+        int id = (int) ((seed >> 16) % max_id);
+        int score = (int) ((seed >> 4) % 100);
+        bool shrinking = (op / 400) % 2 == 1;
+        if (scores[id] < 0) {
+            if (shrinking && (seed >> 10) % 8 != 0)
+                continue;
+            with.addGladiator(id, score);
+            without.addGladiator(id, score);
+            scores[id] = score;
+        } else if ((seed >> 10) % 4 < (shrinking ? 3u : 1u)) {
+            with.removeGladiator(id);
+            without.removeGladiator(id);
+            scores[id] = -1;
+        } else {
+            with.updateScore(id, score);
+            without.updateScore(id, score);
+            scores[id] = score;
+        }
+        ASSERT_TRUE(columnsMatch(with, scores, max_id));
+        ASSERT_EQUALS(without.sumOfScores(), with.sumOfScores());
+        ASSERT_EQUALS(without.countAbove(score), with.countAbove(score));
+        if (with.getNumOfGladiators() > 0) {
+            ASSERT_EQUALS(without.minScore(), with.minScore());
+            ASSERT_EQUALS(without.maxScore(), with.maxScore());
+        }
+    }
+
+    //copies, assignment, absorb and load keep the columns in step
+    Group copy(with);
+    ASSERT_TRUE(columnsMatch(copy, scores, max_id));
+    Group assigned(3);
+    assigned = with;
+    ASSERT_TRUE(columnsMatch(assigned, scores, max_id));
+    Group other(4);
+    for (int id = max_id; id < max_id + GROUP_SMALL_SIZE * 2; id += 2)
+        other.addGladiator(id, id);
+    int all[max_id + GROUP_SMALL_SIZE * 2];
+    for (int id = 0; id < max_id + GROUP_SMALL_SIZE * 2; id++)
+        all[id] = id < max_id ? scores[id] : (id % 2 == 0 ? id : -1);
+    with.absorb(other);
+    ASSERT_TRUE(columnsMatch(with, all, max_id + GROUP_SMALL_SIZE * 2));
+    ASSERT_EQUALS(0, other.getNumOfGladiators());
+    other.addGladiator(with.getColumnIds()[0], 1);
+    ASSERT_THROWS(Group::KeyAlreadyExist, with.absorb(other));
+    ASSERT_TRUE(columnsMatch(with, all, max_id + GROUP_SMALL_SIZE * 2));
+
+    Gladiator loaded[3] = {Gladiator(2, 5), Gladiator(4, 9), Gladiator(8, 1)};
+    with.loadGladiators(loaded, 3);
+    ASSERT_EQUALS(3, with.getNumOfGladiators());
+    ASSERT_EQUALS(8, with.getColumnIds()[2]);
+    ASSERT_EQUALS(9, with.getColumnScores()[1]);
+    ASSERT_EQUALS(15, with.sumOfScores());
+    ASSERT_EQUALS(1, with.minScore());
+    ASSERT_EQUALS(9, with.maxScore());
+    ASSERT_EQUALS(1, with.countAbove(5));
+    with.disableColumns();
+    ASSERT_FALSE(with.hasColumns());
+    ASSERT_EQUALS(15, with.sumOfScores());
+    ASSERT_EQUALS(1, with.countAbove(5));
+}
+
+int main() {
+    RUN_TEST(testScoreKey);
+    RUN_TEST(testAddRemove);
+    RUN_TEST(testScoreQueries);
+    RUN_TEST(testAgainstScan);
+    RUN_TEST(testLoadAndCopy);
+    RUN_TEST(testAbsorb);
+    RUN_TEST(testObserver);
+    RUN_TEST(testCache);
+    RUN_TEST(testSmallGroups);
+    RUN_TEST(testSmallAbsorb);
+    RUN_TEST(testColumns);
+    return 0;
+}
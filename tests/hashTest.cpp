@@ -6,10 +6,9 @@
 void testInit() {
     int arr[5] = {1, 3, 83, 11, 4};
     HashTable hash(arr, 5);
-    for (int i = 0; i < 10; i++) {
-        List<Group> current = hash.getList(i);
-        i++;
-        i--;
+    ASSERT_EQUALS(5, hash.getSize());
+    for (int i = 0; i < 5; i++) {
+        ASSERT_EQUALS(arr[i], hash.find(arr[i]).getID());
     }
 }
 
@@ -19,17 +18,14 @@ void testInsert() {
     ASSERT_NO_THROW(hash.insert(Group(2)));
     ASSERT_NO_THROW(hash.insert(Group(9)));
     ASSERT_NO_THROW(hash.insert(Group(4)));
-    for (int i = 0; i < 6; i++) {
-        List<Group> current = hash.getList(i);
-        i++;
-        i--;
-    }
+    ASSERT_EQUALS(6, hash.getSize());
     ASSERT_NO_THROW(hash.insert(Group(13)));
-    for (int i = 0; i < 12; i++) {
-        List<Group> current = hash.getList(i);
-        i++;
-        i--;
+    for (int i = 0; i < 100; i++) { //enough to grow the table a few times
+        ASSERT_NO_THROW(hash.insert(Group(1000 + i)));
     }
+    ASSERT_EQUALS(107, hash.getSize());
+    ASSERT_EQUALS(13, hash.find(13).getID());
+    ASSERT_EQUALS(1099, hash.find(1099).getID());
     bool thrown = false;
     try {
         hash.insert(Group(3));
@@ -60,8 +56,292 @@ void testFind() {
 
 }
 
+void testRemove() {
+    int arr[5] = {1, 5, 15, 3, 7};
+    HashTable hash(arr, 5);
+    ASSERT_NO_THROW(hash.remove(15));
+    ASSERT_THROWS(HashTable::KeyNotFound, hash.find(15));
+    ASSERT_THROWS(HashTable::KeyNotFound, hash.remove(15));
+    ASSERT_EQUALS(4, hash.getSize());
+    ASSERT_EQUALS(5, hash.find(5).getID());
+    ASSERT_NO_THROW(hash.insert(Group(15)));
+    ASSERT_EQUALS(15, hash.find(15).getID());
+
+    //grow and then shrink back
+    for (int i = 100; i < 200; i++) {
+        hash.insert(Group(i));
+    }
+    ASSERT_EQUALS(105, hash.getSize());
+    for (int i = 100; i < 200; i++) {
+        ASSERT_NO_THROW(hash.remove(i));
+    }
+    ASSERT_EQUALS(5, hash.getSize());
+    ASSERT_EQUALS(1, hash.find(1).getID());
+    ASSERT_EQUALS(7, hash.find(7).getID());
+    ASSERT_THROWS(HashTable::KeyNotFound, hash.find(150));
+}
+
+void testBulkInit() {
+    int duplicates[4] = {1, 3, 7, 3};
+    ASSERT_THROWS(HashTable::KeyAlreadyExist, HashTable(duplicates, 4));
+    int invalid[3] = {1, -3, 7};
+    ASSERT_THROWS(Group::InvalidInput, HashTable(invalid, 3));
+    ASSERT_THROWS(HashTable::InvalidSize, HashTable(invalid, 0));
+    //too many ids for any capacity, rejected before the ids are read
+    ASSERT_THROWS(HashTable::InvalidSize,
+                  HashTable(invalid, HASH_TABLE_MAX_SIZE / 2 + 1));
+
+    const int n = 200000;
+    int* ids = new int[n];
+    for (int i = 0; i < n; i++)
+        ids[i] = (i * 7) % n; //a permutation of 0..n-1
+    HashTable hash(ids, n, 4);
+    ASSERT_EQUALS(n, hash.getSize());
+    for (int i = 0; i < n; i += 997)
+        ASSERT_EQUALS(i, hash.find(i).getID());
+    ASSERT_FALSE(hash.contains(n));
+    ids[n - 1] = ids[0];
+    ASSERT_THROWS(HashTable::KeyAlreadyExist, HashTable(ids, n, 4));
+    delete[] ids;
+}
+
+void testChurn() {
+    const int range = 3000;
+    bool present[range] = {false};
+    int ids[1] = {0};
+    HashTable hash(ids, 1);
+    present[0] = true;
+    int size = 1;
+    unsigned int seed = 7;
+    for (int op = 0; op < 200000; op++) {
+        seed = seed * 1103515245u + 12345u;
+        int id = (int) ((seed >> 8) % range);
+        //alternate between phases that mostly insert and mostly remove
+        bool insert = ((seed >> 4) % 8) < ((op / 20000) % 2 ? 2u : 6u);
+        if (insert) {
+            if (present[id]) {
+                ASSERT_THROWS(HashTable::KeyAlreadyExist,
+                              hash.insert(Group(id)));
+            } else {
+                hash.insert(Group(id));
+                present[id] = true;
+                size++;
+            }
+        } else {
+            if (present[id]) {
+                hash.remove(id);
+                present[id] = false;
+                size--;
+            } else {
+                ASSERT_THROWS(HashTable::KeyNotFound, hash.remove(id));
+            }
+        }
+        ASSERT_EQUALS(size, hash.getSize());
+    }
+    for (int id = 0; id < range; id++) {
+        ASSERT_EQUALS(present[id], hash.contains(id));
+    }
+    HashTable copy(hash);
+    for (int id = 0; id < range; id++) {
+        ASSERT_EQUALS(present[id], copy.contains(id));
+    }
+    int total = 0;
+    for (int i = 0; i < HASH_TABLE_PROBE_HISTOGRAM; i++)
+        total += copy.getStats().probe_histogram[i];
+    ASSERT_EQUALS(size, total);
+}
+
+void testFindBatch() {
+    int arr[6] = {1, 5, 15, 3, 7, 100};
+    HashTable hash(arr, 6);
+    int keys[40];
+    for (int i = 0; i < 40; i++)
+        keys[i] = i * 5 - 5; //-5, 0, 5, ... 190
+    Group* out[40];
+    ASSERT_EQUALS(3, hash.findBatch(keys, 40, out));
+    for (int i = 0; i < 40; i++) {
+        if (keys[i] == 5 || keys[i] == 15 || keys[i] == 100) {
+            ASSERT_TRUE(out[i] == &hash.find(keys[i]));
+        } else {
+            ASSERT_TRUE(out[i] == NULL);
+        }
+    }
+    keys[0] = 1;
+    keys[1] = 1;
+    ASSERT_EQUALS(2, hash.findBatch(keys, 2, out));
+    ASSERT_EQUALS(1, out[1]->getID());
+}
+
+int histogramTotal(const HashTable::Stats& stats) {
+    int total = 0;
+    for (int i = 0; i < HASH_TABLE_PROBE_HISTOGRAM; i++)
+        total += stats.probe_histogram[i];
+    return total;
+}
+
+void testStats() {
+    int arr[5] = {1, 5, 15, 3, 7};
+    HashTable hash(arr, 5);
+    HashTable::Stats stats = hash.getStats();
+    ASSERT_EQUALS(5, stats.size);
+    ASSERT_EQUALS(5, histogramTotal(stats));
+    ASSERT_EQUALS(0, stats.num_of_rehashes);
+    ASSERT_TRUE(stats.load_factor > 0 && stats.load_factor <= 0.5);
+    ASSERT_TRUE(stats.bytes_used >= 5 * sizeof(Group));
+
+    for (int i = 100; i < 1100; i++)
+        hash.insert(Group(i));
+    stats = hash.getStats();
+    ASSERT_EQUALS(1005, histogramTotal(stats));
+    ASSERT_TRUE(stats.num_of_rehashes > 0);
+    ASSERT_TRUE(stats.load_factor <= 0.875);
+    ASSERT_TRUE(stats.max_probe_length < HASH_TABLE_PROBE_HISTOGRAM);
+
+    int rehashes = stats.num_of_rehashes;
+    for (int i = 100; i < 1100; i++)
+        hash.remove(i);
+    stats = hash.getStats();
+    ASSERT_EQUALS(5, stats.size);
+    ASSERT_EQUALS(5, histogramTotal(stats));
+    ASSERT_TRUE(stats.num_of_rehashes > rehashes); //shrunk
+    ASSERT_TRUE(stats.capacity < 1005);
+}
+
+class SumIDs {
+public:
+    long sum;
+    int count;
+
+    SumIDs() : sum(0), count(0) {}
+
+    void operator()(Group& group) {
+        sum += group.getID();
+        count++;
+    }
+};
+
+/**only accepts const groups, so it compiles only against a const table */
+class SumConstIDs {
+public:
+    long sum;
+
+    SumConstIDs() : sum(0) {}
+
+    void operator()(const Group& group) {
+        sum += group.getID();
+    }
+};
+
+void testIteration() {
+    int arr[5] = {1, 5, 15, 3, 7};
+    HashTable hash(arr, 5);
+    for (int i = 100; i < 300; i++)
+        hash.insert(Group(i));
+    hash.remove(150);
+    long expected = 1 + 5 + 15 + 3 + 7 + (100 + 299) * 200 / 2 - 150;
+
+    long sum = 0;
+    int count = 0;
+    for (HashTable::Iterator it = hash.begin(); it != hash.end(); ++it) {
+        sum += (*it).getID();
+        count++;
+    }
+    ASSERT_EQUALS(204, count);
+    ASSERT_EQUALS(expected, sum);
+
+    SumIDs all;
+    hash.forEach(all);
+    ASSERT_EQUALS(204, all.count);
+    ASSERT_EQUALS(expected, all.sum);
+
+    //split into uneven ranges
+    SumIDs parts;
+    int capacity = hash.getCapacity();
+    int cuts[5] = {0, 3, capacity / 2 + 1, capacity - 5, capacity};
+    for (int i = 0; i < 4; i++)
+        hash.forEach(parts, cuts[i], cuts[i + 1]);
+    ASSERT_EQUALS(204, parts.count);
+    ASSERT_EQUALS(expected, parts.sum);
+    ASSERT_THROWS(HashTable::InvalidSize, hash.forEach(parts, 0, capacity + 1));
+
+    //references point into the table, no copies
+    ASSERT_TRUE(&*hash.begin() == &hash.find(hash.begin()->getID()));
+
+    const HashTable& read_only = hash;
+    sum = 0;
+    for (HashTable::ConstIterator it = read_only.begin();
+         it != read_only.end(); ++it)
+        sum += it->getID();
+    ASSERT_EQUALS(expected, sum);
+    HashTable::ConstIterator first = hash.begin();
+    ASSERT_TRUE(first == read_only.begin());
+    SumConstIDs const_all;
+    read_only.forEach(const_all);
+    ASSERT_EQUALS(expected, const_all.sum);
+}
+
+void testAbsorb() {
+    int arr[6] = {1, 2, 3, 4, 5, 6};
+    HashTable hash(arr, 6);
+    hash.find(1).addGladiator(10, 5);
+    hash.find(2).addGladiator(20, 7);
+    hash.find(3).addGladiator(30, 1);
+    hash.find(4).addGladiator(10, 2);
+
+    hash.absorb(1, 2);
+    ASSERT_EQUALS(5, hash.getSize());
+    ASSERT_EQUALS(1, hash.find(2).getID()); //the stale id resolves
+    ASSERT_TRUE(hash.contains(2));
+    ASSERT_EQUALS(2, hash.find(1).getNumOfGladiators());
+    ASSERT_THROWS(HashTable::KeyAlreadyExist, hash.insert(Group(2)));
+
+    //absorbing through stale ids, in chains
+    hash.absorb(3, 1);
+    hash.absorb(5, 3);
+    ASSERT_EQUALS(3, hash.getSize());
+    const HashTable& read_only = hash;
+    for (int id = 1; id <= 5; id += 2)
+        ASSERT_EQUALS(5, read_only.find(id).getID());
+    ASSERT_EQUALS(5, hash.find(2).getID());
+    ASSERT_EQUALS(3, hash.find(2).getNumOfGladiators());
+    ASSERT_NO_THROW(hash.absorb(2, 5)); //the same group already
+    ASSERT_EQUALS(3, hash.getSize());
+
+    //a shared gladiator fails the absorb without changing anything
+    ASSERT_THROWS(Group::KeyAlreadyExist, hash.absorb(4, 2));
+    ASSERT_EQUALS(3, hash.getSize());
+    ASSERT_EQUALS(1, hash.find(4).getNumOfGladiators());
+    ASSERT_NO_THROW(hash.insert(Group(4000)));
+    ASSERT_THROWS(HashTable::KeyNotFound, hash.absorb(4, 7));
+
+    Group* found[3];
+    int ids[3] = {2, 7, 6};
+    ASSERT_EQUALS(2, hash.findBatch(ids, 3, found));
+    ASSERT_EQUALS(5, found[0]->getID());
+    ASSERT_TRUE(found[1] == NULL);
+
+    HashTable copy(hash);
+    ASSERT_EQUALS(5, copy.find(1).getID());
+
+    //removing through a stale id retires the whole set
+    hash.remove(3);
+    ASSERT_FALSE(hash.contains(5));
+    ASSERT_FALSE(hash.contains(1));
+    ASSERT_THROWS(HashTable::KeyNotFound, hash.find(2));
+    ASSERT_THROWS(HashTable::KeyAlreadyExist, hash.insert(Group(5)));
+    ASSERT_EQUALS(3, hash.getSize());
+    ASSERT_EQUALS(5, copy.find(2).getID());
+}
+
 int main() {
     RUN_TEST(testInit);
     RUN_TEST(testInsert);
     RUN_TEST(testFind);
+    RUN_TEST(testRemove);
+    RUN_TEST(testBulkInit);
+    RUN_TEST(testChurn);
+    RUN_TEST(testFindBatch);
+    RUN_TEST(testStats);
+    RUN_TEST(testIteration);
+    RUN_TEST(testAbsorb);
 }
@@ -0,0 +1,77 @@
+#include "../IntMap.h"
+
+#include "testUtility.h"
+#include <cassert>
+
+void testInsertFind() {
+    IntMap<int> map;
+    ASSERT_EQUALS(0, map.getSize());
+    ASSERT_TRUE(map.find(3) == NULL);
+    map.insert(3, 30);
+    map.insert(-7, 70);
+    ASSERT_EQUALS(2, map.getSize());
+    ASSERT_EQUALS(30, *map.find(3));
+    ASSERT_EQUALS(70, *map.find(-7));
+    *map.find(3) = 33;
+    ASSERT_EQUALS(33, *map.find(3));
+    ASSERT_THROWS(IntMap<int>::KeyAlreadyExist, map.insert(3, 1));
+    ASSERT_THROWS(IntMap<int>::KeyNotFound, map.remove(4));
+    map.remove(3);
+    ASSERT_TRUE(map.find(3) == NULL);
+    ASSERT_EQUALS(1, map.getSize());
+}
+
+void testGrowAndShrink() {
+    IntMap<long long> map;
+    for (int i = 0; i < 10000; i++)
+        map.insert(i * 7, (long long) i * i);
+    ASSERT_EQUALS(10000, map.getSize());
+    for (int i = 0; i < 10000; i++) {
+        ASSERT_EQUALS((long long) i * i, *map.find(i * 7));
+        ASSERT_TRUE(map.find(i * 7 + 1) == NULL);
+    }
+    for (int i = 0; i < 10000; i += 2)
+        map.remove(i * 7);
+    for (int i = 0; i < 9990; i++) {
+        if (i % 2 == 1)
+            map.remove(i * 7);
+    }
+    ASSERT_EQUALS(5, map.getSize());
+    ASSERT_EQUALS(9999LL * 9999, *map.find(9999 * 7));
+    ASSERT_TRUE(map.find(0) == NULL);
+}
+
+void testChurn() {
+    //tombstones are recycled, the map doesn't grow under steady churn
+    IntMap<int> map;
+    for (int round = 0; round < 100000; round++) {
+        map.insert(round, round);
+        if (round >= 10)
+            map.remove(round - 10);
+    }
+    ASSERT_EQUALS(10, map.getSize());
+    for (int i = 0; i < 10; i++)
+        ASSERT_EQUALS(99990 + i, *map.find(99990 + i));
+}
+
+void testCopy() {
+    IntMap<int> map;
+    for (int i = 0; i < 100; i++)
+        map.insert(i, -i);
+    IntMap<int> copy(map);
+    map.remove(5);
+    ASSERT_EQUALS(-5, *copy.find(5));
+    copy = map;
+    ASSERT_TRUE(copy.find(5) == NULL);
+    ASSERT_EQUALS(99, copy.getSize());
+    copy = copy;
+    ASSERT_EQUALS(-99, *copy.find(99));
+}
+
+int main() {
+    RUN_TEST(testInsertFind);
+    RUN_TEST(testGrowAndShrink);
+    RUN_TEST(testChurn);
+    RUN_TEST(testCopy);
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include "../Leaderboard.h"
+
+#include "testUtility.h"
+
+void testOrder() {
+    Leaderboard board;
+    ASSERT_EQUALS(0, board.topKWeight(0));
+    ASSERT_THROWS(Leaderboard::InvalidInput, board.select(1));
+    board.add(5, 30);
+    board.add(2, 30);
+    board.add(9, 100);
+    board.add(1, 0);
+    ASSERT_THROWS(Leaderboard::KeyAlreadyExist, board.add(5, 30));
+    //100(9) 30(2) 30(5) 0(1)
+    ASSERT_EQUALS(9, board.select(1));
+    ASSERT_EQUALS(2, board.select(2));
+    ASSERT_EQUALS(5, board.select(3));
+    ASSERT_EQUALS(1, board.select(4));
+    ASSERT_EQUALS(3, board.rank(5, 30));
+    ASSERT_EQUALS(160, board.topKWeight(3));
+    ASSERT_EQUALS(160, board.topKWeight(4));
+    ASSERT_THROWS(Leaderboard::InvalidInput, board.topKWeight(5));
+    ASSERT_THROWS(Leaderboard::InvalidInput, board.select(0));
+    ASSERT_THROWS(Leaderboard::KeyNotFound, board.rank(5, 31));
+}
+
+void testUpdateRemove() {
+    Leaderboard board;
+    for (int id = 0; id < 10; id++)
+        board.add(id, id * 10);
+    board.update(0, 0, 1000);
+    ASSERT_EQUALS(0, board.select(1));
+    ASSERT_EQUALS(1, board.rank(0, 1000));
+    ASSERT_THROWS(Leaderboard::KeyNotFound, board.update(0, 0, 5));
+    ASSERT_EQUALS(1, board.rank(0, 1000));
+    board.remove(9, 90);
+    ASSERT_THROWS(Leaderboard::KeyNotFound, board.remove(9, 90));
+    ASSERT_EQUALS(9, board.getSize());
+    ASSERT_EQUALS(8, board.select(2));
+    ASSERT_EQUALS(1080, board.topKWeight(2));
+}
+
+int main() {
+    RUN_TEST(testOrder);
+    RUN_TEST(testUpdateRemove);
+    return 0;
+}
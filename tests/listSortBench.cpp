@@ -0,0 +1,116 @@
+/**LIST SORT BENCHMARK
+ * times List::sort (bottom-up merge sort, relinks nodes) next to the bubble
+ * sort it replaced (swaps the data by copying) on 10^3..10^6 random items.
+ * The items carry a payload, so copying one costs like copying a small
+ * object. The bubble sort is quadratic and is skipped past BUBBLE_MAX_SIZE.
+ * build: g++ -O2 -DNDEBUG listSortBench.cpp
+ * usage: listSortBench */
+
+#include "../list.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define BUBBLE_MAX_SIZE 20000
+
+class Item {
+    int key;
+    int payload[15];
+
+public:
+    explicit Item(int key) : key(key) {
+        for (int i = 0; i < 15; i++)
+            payload[i] = key + i;
+    }
+
+    int getKey() const {
+        return key;
+    }
+
+    bool operator==(const Item& item) const {
+        return key == item.key;
+    }
+
+    bool operator!=(const Item& item) const {
+        return !(*this == item);
+    }
+};
+
+class CompareKeys {
+public:
+    bool operator()(const Item& first, const Item& second) const {
+        return first.getKey() <= second.getKey();
+    }
+};
+
+/**the previous List::sort, over the public iterator */
+template<class Compare>
+void bubbleSort(List<Item>& list, const Compare& compare) {
+    bool not_sorted = true;
+    int len = list.getSize() - 1;
+    while (len > 0 && not_sorted) {
+        not_sorted = false;
+        List<Item>::Iterator it = list.begin();
+        for (int i = 0; i < len; i++) {
+            List<Item>::Iterator next = it;
+            next++;
+            if (compare(*it, *next) == false) {
+                Item temp = *it;
+                *it = *next;
+                *next = temp;
+                not_sorted = true;
+            }
+            it++;
+        }
+        len--;
+    }
+}
+
+void fill(List<Item>& list, int n) {
+    unsigned int seed = 12345u;
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        list.insert(Item((int) (seed >> 1)));
+    }
+}
+
+double secondsSince(clock_t start) {
+    return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+bool isSorted(const List<Item>& list) {
+    List<Item>::Iterator previous = list.begin();
+    for (List<Item>::Iterator it = list.begin(); it != list.end(); ++it) {
+        if ((*previous).getKey() > (*it).getKey())
+            return false;
+        previous = it;
+    }
+    return true;
+}
+
+int main() {
+    printf("%10s %16s %16s\n", "items", "merge sort (s)", "bubble sort (s)");
+    for (int n = 1000; n <= 1000000; n *= 10) {
+        List<Item> merged;
+        fill(merged, n);
+        clock_t start = clock();
+        merged.sort(CompareKeys());
+        double merge_time = secondsSince(start);
+        if (!isSorted(merged))
+            printf("merge sort failed\n");
+
+        if (n > BUBBLE_MAX_SIZE) {
+            printf("%10d %16.4f %16s\n", n, merge_time, "skipped");
+            continue;
+        }
+        List<Item> bubbled;
+        fill(bubbled, n);
+        start = clock();
+        bubbleSort(bubbled, CompareKeys());
+        double bubble_time = secondsSince(start);
+        if (bubbled != merged)
+            printf("results differ\n");
+        printf("%10d %16.4f %16.4f\n", n, merge_time, bubble_time);
+    }
+    return 0;
+}
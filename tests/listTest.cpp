@@ -0,0 +1,300 @@
+#include "../list.h"
+
+#include "testUtility.h"
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+/**a type without a default constructor */
+class Item {
+    int value;
+public:
+    explicit Item(int value) : value(value) {}
+
+    int getValue() const {
+        return value;
+    }
+
+    bool operator==(const Item& item) const {
+        return value == item.value;
+    }
+
+    bool operator!=(const Item& item) const {
+        return !(*this == item);
+    }
+};
+
+class Equals {
+    int value;
+public:
+    explicit Equals(int value) : value(value) {}
+
+    bool operator()(const Item& item) const {
+        return item.getValue() == value;
+    }
+};
+
+void testEmpty() {
+    List<Item> list;
+    ASSERT_EQUALS(0, list.getSize());
+    ASSERT_TRUE(list.begin() == list.end());
+#ifndef NDEBUG //unchecked in release builds
+    ASSERT_THROWS(List<Item>::ElementNotFound, *list.begin());
+#endif
+    ASSERT_THROWS(List<Item>::ElementNotFound, list.remove(list.begin()));
+    List<Item> copy(list);
+    ASSERT_TRUE(copy == list);
+}
+
+void testInsertRemove() {
+    List<Item> list;
+    list.insert(Item(1));
+    list.insert(Item(3));
+    list.insert(Item(2), list.find(Equals(3)));
+    ASSERT_EQUALS(3, list.getSize());
+    List<Item>::Iterator it = list.begin();
+    ASSERT_EQUALS(1, (*it).getValue());
+    ASSERT_EQUALS(2, (*++it).getValue());
+    ASSERT_EQUALS(3, (*++it).getValue());
+    ASSERT_TRUE(++it == list.end());
+    ASSERT_EQUALS(3, (*--it).getValue());
+
+    list.remove(list.find(Equals(2)));
+    ASSERT_EQUALS(2, list.getSize());
+    ASSERT_TRUE(list.find(Equals(2)) == list.end());
+
+    List<Item> other;
+    ASSERT_THROWS(List<Item>::ElementNotFound, other.remove(list.begin()));
+    ASSERT_THROWS(List<Item>::ElementNotFound,
+                  other.insert(Item(5), list.begin()));
+
+    List<Item> copy(list);
+    ASSERT_TRUE(copy == list);
+    copy.remove(copy.begin());
+    ASSERT_TRUE(copy != list);
+    copy = list;
+    ASSERT_TRUE(copy == list);
+    list.remove(list.begin());
+    list.remove(list.begin());
+    ASSERT_EQUALS(0, list.getSize());
+    ASSERT_TRUE(list.begin() == list.end());
+}
+
+/**orders items by value / 1000 only, items in the same thousand are equal */
+class CompareThousands {
+public:
+    bool operator()(const Item& first, const Item& second) const {
+        return first.getValue() / 1000 <= second.getValue() / 1000;
+    }
+};
+
+void testSort() {
+    List<Item> empty;
+    empty.sort(CompareThousands());
+    ASSERT_EQUALS(0, empty.getSize());
+
+    List<Item> list;
+    const int n = 999;
+    unsigned int seed = 17;
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        //a random thousand, and the insertion index to check stability
+        list.insert(Item((int) ((seed >> 16) % 50) * 1000 + i));
+    }
+    List<Item>::Iterator first = list.begin();
+    Item first_item = *first;
+    list.sort(CompareThousands());
+    ASSERT_EQUALS(n, list.getSize());
+    //the nodes were relinked, iterators still point to the same item
+    ASSERT_TRUE(*first == first_item);
+
+    int count = 0;
+    List<Item>::Iterator previous = list.end();
+    for (List<Item>::Iterator it = list.begin(); it != list.end(); ++it) {
+        if (previous != list.end()) {
+            int before = (*previous).getValue();
+            int current = (*it).getValue();
+            ASSERT_TRUE(before / 1000 <= current / 1000);
+            if (before / 1000 == current / 1000) //stable
+                ASSERT_TRUE(before < current);
+        }
+        previous = it;
+        count++;
+    }
+    ASSERT_EQUALS(n, count);
+    //walking back over the rebuilt previous links
+    count = 0;
+    for (List<Item>::Iterator it = previous; it != list.begin(); --it)
+        count++;
+    ASSERT_EQUALS(n - 1, count);
+}
+
+class CompareValues {
+public:
+    bool operator()(const Item& first, const Item& second) const {
+        return first.getValue() <= second.getValue();
+    }
+};
+
+/**@return true if the values of list are values[0..n), checked forwards and
+ *         backwards */
+bool holds(const List<Item>& list, const int* values, int n) {
+    if (list.getSize() != n)
+        return false;
+    List<Item>::Iterator it = list.begin();
+    for (int i = 0; i < n; i++, ++it) {
+        if (it == list.end() || (*it).getValue() != values[i])
+            return false;
+    }
+    if (it != list.end())
+        return false;
+    for (int i = n - 1; i >= 0; i--) {
+        --it;
+        if ((*it).getValue() != values[i])
+            return false;
+    }
+    return true;
+}
+
+void testSplice() {
+    List<Item> list;
+    List<Item> other;
+    for (int i = 1; i <= 4; i++) {
+        list.insert(Item(i));
+        other.insert(Item(i * 10));
+    }
+    //a single item from another list, its node and data are kept
+    Item* moved = &*other.find(Equals(20));
+    list.splice(list.find(Equals(3)), other, other.find(Equals(20)));
+    int single[5] = {1, 2, 20, 3, 4};
+    ASSERT_TRUE(holds(list, single, 5));
+    ASSERT_TRUE(&*list.find(Equals(20)) == moved);
+    ASSERT_EQUALS(3, other.getSize());
+
+    //a range from another list: [30, end)
+    list.splice(list.begin(), other, other.find(Equals(30)), other.end());
+    int range[7] = {30, 40, 1, 2, 20, 3, 4};
+    ASSERT_TRUE(holds(list, range, 7));
+    int left[1] = {10};
+    ASSERT_TRUE(holds(other, left, 1));
+
+    //a range inside the same list: [1, 20) to the end
+    list.splice(list.end(), list, list.find(Equals(1)), list.find(Equals(20)));
+    int rotated[7] = {30, 40, 20, 3, 4, 1, 2};
+    ASSERT_TRUE(holds(list, rotated, 7));
+
+    //the whole list
+    list.splice(list.find(Equals(3)), other);
+    int whole[8] = {30, 40, 20, 10, 3, 4, 1, 2};
+    ASSERT_TRUE(holds(list, whole, 8));
+    ASSERT_EQUALS(0, other.getSize());
+    ASSERT_TRUE(other.begin() == other.end());
+
+    ASSERT_THROWS(List<Item>::ElementNotFound,
+                  list.splice(other.begin(), list));
+    ASSERT_THROWS(List<Item>::ElementNotFound,
+                  other.splice(other.end(), list, list.end()));
+    ASSERT_THROWS(List<Item>::ElementNotFound,
+                  other.splice(other.end(), list, other.begin()));
+}
+
+void testMerge() {
+    List<Item> list;
+    List<Item> other;
+    int first[4] = {1, 3, 3, 7};
+    int second[5] = {0, 3, 4, 8, 9};
+    for (int i = 0; i < 4; i++)
+        list.insert(Item(first[i] * 10));
+    for (int i = 0; i < 5; i++)
+        other.insert(Item(second[i] * 10 + 1)); //the ones digit marks other
+    list.merge(other, CompareThousands());
+    ASSERT_EQUALS(0, other.getSize());
+    //all values compare equal (same thousand), so merge keeps this list first
+    int stable[9] = {10, 30, 30, 70, 1, 31, 41, 81, 91};
+    ASSERT_TRUE(holds(list, stable, 9));
+
+    List<Item> sorted;
+    List<Item> more;
+    for (int i = 0; i < 4; i++)
+        sorted.insert(Item(first[i]));
+    for (int i = 0; i < 5; i++)
+        more.insert(Item(second[i]));
+    sorted.merge(more, CompareValues());
+    int merged[9] = {0, 1, 3, 3, 3, 4, 7, 8, 9};
+    ASSERT_TRUE(holds(sorted, merged, 9));
+
+    List<Item> empty;
+    empty.merge(sorted, CompareValues());
+    ASSERT_TRUE(holds(empty, merged, 9));
+    ASSERT_EQUALS(0, sorted.getSize());
+}
+
+void testAssignment() {
+    List<Item> list;
+    List<Item> longer;
+    for (int i = 0; i < 6; i++)
+        longer.insert(Item(i));
+    list.insert(Item(100));
+    Item* reused = &*list.begin();
+    list = longer;
+    ASSERT_TRUE(list == longer);
+    ASSERT_TRUE(&*list.begin() == reused); //the node was reused
+    List<Item> shorter;
+    shorter.insert(Item(7));
+    list = shorter;
+    ASSERT_TRUE(list == shorter);
+    ASSERT_EQUALS(1, list.getSize());
+#if __cplusplus >= 201103L
+    List<Item> moved(static_cast<List<Item>&&>(longer));
+    ASSERT_EQUALS(6, moved.getSize());
+    ASSERT_EQUALS(0, longer.getSize());
+    ASSERT_TRUE(longer.begin() == longer.end());
+    Item* first = &*moved.begin();
+    list = static_cast<List<Item>&&>(moved);
+    ASSERT_EQUALS(6, list.getSize());
+    ASSERT_TRUE(&*list.begin() == first);
+    ASSERT_EQUALS(5, (*--list.end()).getValue());
+    ASSERT_EQUALS(0, moved.getSize());
+    moved.insert(Item(1)); //a moved from list is still usable
+    ASSERT_EQUALS(1, moved.getSize());
+#endif
+}
+
+class SumValues {
+public:
+    int operator()(int sum, const Item& item) const {
+        return sum + item.getValue();
+    }
+};
+
+void testStandardAlgorithms() {
+    List<Item> list;
+    for (int i = 1; i <= 10; i++)
+        list.insert(Item(i));
+    ASSERT_EQUALS(55, std::accumulate(list.begin(), list.end(), 0,
+                                      SumValues()));
+    ASSERT_EQUALS(7, std::find_if(list.begin(), list.end(),
+                                  Equals(7))->getValue());
+    ASSERT_TRUE(std::find(list.begin(), list.end(), Item(11)) == list.end());
+    ASSERT_EQUALS(10, (int) std::distance(list.begin(), list.end()));
+    std::reverse(list.begin(), list.end());
+    ASSERT_EQUALS(10, list.begin()->getValue());
+    ASSERT_EQUALS(1, std::count_if(list.begin(), list.end(), Equals(3)));
+#if __cplusplus >= 201103L
+    int sum = 0;
+    for (const Item& item : list)
+        sum += item.getValue();
+    ASSERT_EQUALS(55, sum);
+#endif
+}
+
+int main() {
+    RUN_TEST(testEmpty);
+    RUN_TEST(testInsertRemove);
+    RUN_TEST(testSort);
+    RUN_TEST(testSplice);
+    RUN_TEST(testMerge);
+    RUN_TEST(testAssignment);
+    RUN_TEST(testStandardAlgorithms);
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "../scoreReduce.h"
+
+#include "testUtility.h"
+#include <limits.h>
+
+#define MAX_LENGTH 100
+
+/**fills values with a mix of small, negative and extreme values */
+void fill(int* values, int n, unsigned int seed) {
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        switch ((seed >> 8) % 8) {
+            case 0:
+                values[i] = INT_MAX;
+                break;
+            case 1:
+                values[i] = INT_MIN;
+                break;
+            default:
+                values[i] = (int) ((seed >> 12) % 2001) - 1000;
+        }
+    }
+}
+
+void testAgainstScalar() {
+    //every length and offset, so the vector steps, the tail and unaligned
+    //loads are all covered
+    int buffer[MAX_LENGTH + 8];
+    for (int offset = 0; offset < 8; offset++) {
+        for (int n = 0; n <= MAX_LENGTH - offset; n++) {
+            int* values = buffer + offset;
+            fill(values, n, (unsigned int) (n * 8 + offset));
+            long long sum = 0;
+            int count = 0;
+            for (int i = 0; i < n; i++) {
+                sum += values[i];
+                count += values[i] > 17 ? 1 : 0;
+            }
+            ASSERT_EQUALS(sum, reduce::sum(values, n));
+            ASSERT_EQUALS(count, reduce::countAbove(values, n, 17));
+            if (n == 0)
+                continue;
+            int low = values[0], high = values[0];
+            for (int i = 1; i < n; i++) {
+                low = values[i] < low ? values[i] : low;
+                high = values[i] > high ? values[i] : high;
+            }
+            ASSERT_EQUALS(low, reduce::min(values, n));
+            ASSERT_EQUALS(high, reduce::max(values, n));
+        }
+    }
+}
+
+void testExtremes() {
+    int values[20];
+    for (int i = 0; i < 20; i++)
+        values[i] = INT_MAX;
+    ASSERT_EQUALS(20LL * INT_MAX, reduce::sum(values, 20));
+    ASSERT_EQUALS(0, reduce::countAbove(values, 20, INT_MAX));
+    ASSERT_EQUALS(20, reduce::countAbove(values, 20, INT_MIN));
+    values[13] = INT_MIN;
+    ASSERT_EQUALS(INT_MIN, reduce::min(values, 20));
+    ASSERT_EQUALS(INT_MAX, reduce::max(values, 20));
+    ASSERT_EQUALS(19, reduce::countAbove(values, 20, 0));
+}
+
+int main() {
+    RUN_TEST(testAgainstScalar);
+    RUN_TEST(testExtremes);
+    return 0;
+}
@@ -0,0 +1,91 @@
+/**SMALL GROUP BENCHMARK
+ * fills 10^5 groups of 4, 8 and 16 gladiators, then asks each for the sum
+ * of its top half, and prints the time of both and the memory used per
+ * group (the Group itself and what it allocated). Build it twice to
+ * compare inline groups with groups that always use trees.
+ * build: g++ -O2 -DNDEBUG smallGroupBench.cpp ../Group.cpp ../Gladiator.cpp
+ *        g++ -O2 -DNDEBUG -DGROUP_SMALL_SIZE=1 smallGroupBench.cpp ...
+ * usage: smallGroupBench */
+
+#include "../Group.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <new>
+
+#define NUM_OF_GROUPS 100000
+
+#if __cplusplus >= 201103L
+#define THROWS_BAD_ALLOC
+#define THROWS_NOTHING noexcept
+#else
+#define THROWS_BAD_ALLOC throw(std::bad_alloc)
+#define THROWS_NOTHING throw()
+#endif
+
+static long long allocated = 0; //bytes asked from operator new
+
+//called through pointers, so the compiler doesn't pair new and delete with
+//malloc and free and warn about the mix
+static void* (*volatile allocate)(size_t) = malloc;
+static void (*volatile release)(void*) = free;
+
+void* operator new(size_t size) THROWS_BAD_ALLOC {
+    allocated += size;
+    void* memory = allocate(size);
+    if (memory == NULL)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void operator delete(void* memory) THROWS_NOTHING {
+    release(memory);
+}
+
+#if __cplusplus >= 201402L
+void operator delete(void* memory, size_t) noexcept {
+    release(memory);
+}
+#endif
+
+double secondsSince(clock_t start) {
+    return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main() {
+    printf("GROUP_SMALL_SIZE %d, sizeof(Group) %d\n", GROUP_SMALL_SIZE,
+           (int) sizeof(Group));
+    printf("%6s %12s %12s %16s\n", "size", "fill (s)", "query (s)",
+           "bytes per group");
+    for (int size = 4; size <= 16; size *= 2) {
+        Group** groups = new Group* [NUM_OF_GROUPS];
+        long long before = allocated;
+        unsigned int seed = 12345u;
+        clock_t start = clock();
+        for (int i = 0; i < NUM_OF_GROUPS; i++) {
+            groups[i] = new Group(i);
+            for (int j = 0; j < size; j++) {
+                seed = seed * 1103515245u + 12345u;
+                groups[i]->addGladiator(i * size + j,
+                                        (int) ((seed >> 8) % 1000));
+            }
+        }
+        double fill_time = secondsSince(start);
+        long long bytes = allocated - before;
+
+        long long total = 0;
+        start = clock();
+        for (int round = 0; round < 10; round++) {
+            for (int i = 0; i < NUM_OF_GROUPS; i++)
+                total += groups[i]->sumOfTopK(size / 2 + round % 2);
+        }
+        double query_time = secondsSince(start);
+        printf("%6d %12.4f %12.4f %16lld   (%lld)\n", size, fill_time,
+               query_time, bytes / NUM_OF_GROUPS, total);
+        for (int i = 0; i < NUM_OF_GROUPS; i++)
+            delete groups[i];
+        delete[] groups;
+    }
+    return 0;
+}
@@ -0,0 +1,166 @@
+#include "../Snapshot.h"
+
+#include "testUtility.h"
+#include <cassert>
+#include <stddef.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SNAPSHOT_PATH "/tmp/dswet2_snapshot_test.bin"
+
+class CollectGladiators {
+public:
+    int ids[100];
+    int scores[100];
+    int count;
+
+    CollectGladiators() : count(0) {}
+
+    void operator()(const Gladiator& gladiator) {
+        ids[count] = gladiator.getId();
+        scores[count] = gladiator.getScore();
+        count++;
+    }
+};
+
+HashTable* makeTable() {
+    int arr[4] = {10, 3, 7, 20};
+    HashTable* table = new HashTable(arr, 4);
+    Gladiator three[3] = {Gladiator(1, 50), Gladiator(4, 10), Gladiator(9, 30)};
+    table->find(3).loadGladiators(three, 3);
+    Gladiator seven[1] = {Gladiator(2, 5)};
+    table->find(7).loadGladiators(seven, 1);
+    return table;
+}
+
+void testRoundTrip() {
+    HashTable* table = makeTable();
+    Snapshot::write(*table, SNAPSHOT_PATH);
+    delete table;
+
+    FrozenSnapshot frozen(SNAPSHOT_PATH);
+    HashTable* thawed = frozen.thaw();
+    ASSERT_EQUALS(4, thawed->getSize());
+    ASSERT_EQUALS(0, thawed->find(10).getNumOfGladiators());
+    ASSERT_EQUALS(0, thawed->find(20).getNumOfGladiators());
+    ASSERT_EQUALS(1, thawed->find(7).getNumOfGladiators());
+    CollectGladiators collect;
+    thawed->find(3).forEachGladiator(collect);
+    ASSERT_EQUALS(3, collect.count);
+    ASSERT_EQUALS(1, collect.ids[0]);
+    ASSERT_EQUALS(4, collect.ids[1]);
+    ASSERT_EQUALS(9, collect.ids[2]);
+    ASSERT_EQUALS(30, collect.scores[2]);
+    delete thawed;
+}
+
+void testFrozenView() {
+    HashTable* table = makeTable();
+    Snapshot::write(*table, SNAPSHOT_PATH);
+    delete table;
+
+    FrozenSnapshot frozen(SNAPSHOT_PATH);
+    ASSERT_EQUALS(4, frozen.getNumOfGroups());
+    ASSERT_TRUE(frozen.containsGroup(20));
+    ASSERT_FALSE(frozen.containsGroup(21));
+    ASSERT_EQUALS(3, frozen.getNumOfGladiators(3));
+    ASSERT_EQUALS(10, frozen.getScore(3, 4));
+    ASSERT_EQUALS(60, frozen.rankWeight(3, 4));
+    ASSERT_EQUALS(90, frozen.rankWeight(3, 9));
+    ASSERT_EQUALS(9, frozen.select(3, 3));
+    ASSERT_THROWS(FrozenSnapshot::KeyNotFound, frozen.getScore(3, 5));
+    ASSERT_THROWS(FrozenSnapshot::KeyNotFound, frozen.getScore(4, 1));
+    ASSERT_THROWS(FrozenSnapshot::InvalidInput, frozen.select(10, 1));
+}
+
+void testInvalidFile() {
+    ASSERT_THROWS(Snapshot::IOError,
+                  FrozenSnapshot("/tmp/dswet2_no_such_snapshot.bin"));
+    FILE* file = fopen(SNAPSHOT_PATH, "wb");
+    assert(file);
+    const char garbage[100] = "not a snapshot";
+    fwrite(garbage, 1, sizeof(garbage), file);
+    fclose(file);
+    ASSERT_THROWS(Snapshot::InvalidFormat, FrozenSnapshot(SNAPSHOT_PATH));
+
+    //a truncated snapshot
+    HashTable* table = makeTable();
+    Snapshot::write(*table, SNAPSHOT_PATH);
+    delete table;
+    ASSERT_TRUE(truncate(SNAPSHOT_PATH, sizeof(Snapshot::Header) + 8) == 0);
+    ASSERT_THROWS(Snapshot::InvalidFormat, FrozenSnapshot(SNAPSHOT_PATH));
+    remove(SNAPSHOT_PATH);
+}
+
+/**overwrites size bytes at offset of the snapshot file */
+void patchSnapshot(long offset, const void* source, size_t size) {
+    FILE* file = fopen(SNAPSHOT_PATH, "r+b");
+    assert(file);
+    fseek(file, offset, SEEK_SET);
+    fwrite(source, 1, size, file);
+    fclose(file);
+}
+
+void testCorruptFile() {
+    HashTable* table = makeTable();
+    long records =
+            sizeof(Snapshot::Header) + 4 * sizeof(Snapshot::GroupEntry);
+
+    //group 3's gladiators out of order
+    Snapshot::write(*table, SNAPSHOT_PATH);
+    int32_t id = 7;
+    patchSnapshot(records, &id, sizeof(id));
+    ASSERT_THROWS(Snapshot::InvalidFormat, FrozenSnapshot(SNAPSHOT_PATH));
+
+    //a prefix sum that doesn't match the scores
+    Snapshot::write(*table, SNAPSHOT_PATH);
+    int64_t prefix_score = 51;
+    patchSnapshot(records + offsetof(Snapshot::GladiatorRecord, prefix_score),
+                  &prefix_score, sizeof(prefix_score));
+    ASSERT_THROWS(Snapshot::InvalidFormat, FrozenSnapshot(SNAPSHOT_PATH));
+
+    //counts and offsets that overflow when multiplied
+    Snapshot::write(*table, SNAPSHOT_PATH);
+    int64_t huge = (int64_t) 1 << 62;
+    patchSnapshot(offsetof(Snapshot::Header, num_of_gladiators), &huge,
+                  sizeof(huge));
+    ASSERT_THROWS(Snapshot::InvalidFormat, FrozenSnapshot(SNAPSHOT_PATH));
+    Snapshot::write(*table, SNAPSHOT_PATH);
+    patchSnapshot(offsetof(Snapshot::Header, gladiators_offset), &huge,
+                  sizeof(huge));
+    ASSERT_THROWS(Snapshot::InvalidFormat, FrozenSnapshot(SNAPSHOT_PATH));
+    delete table;
+    remove(SNAPSHOT_PATH);
+}
+
+void testFailedWriteKeepsSnapshot() {
+    HashTable* table = makeTable();
+    Snapshot::write(*table, SNAPSHOT_PATH);
+    table->insert(Group(30));
+    //a directory in the way of the temporary file makes the write fail
+    ASSERT_TRUE(mkdir(SNAPSHOT_PATH ".tmp", 0700) == 0);
+    ASSERT_THROWS(Snapshot::IOError, Snapshot::write(*table, SNAPSHOT_PATH));
+    rmdir(SNAPSHOT_PATH ".tmp");
+    {
+        FrozenSnapshot frozen(SNAPSHOT_PATH);
+        ASSERT_EQUALS(4, frozen.getNumOfGroups());
+    }
+    Snapshot::write(*table, SNAPSHOT_PATH);
+    {
+        FrozenSnapshot frozen(SNAPSHOT_PATH);
+        ASSERT_EQUALS(5, frozen.getNumOfGroups());
+    }
+    ASSERT_TRUE(access(SNAPSHOT_PATH ".tmp", F_OK) != 0);
+    delete table;
+    remove(SNAPSHOT_PATH);
+}
+
+int main() {
+    RUN_TEST(testRoundTrip);
+    RUN_TEST(testFrozenView);
+    RUN_TEST(testInvalidFile);
+    RUN_TEST(testCorruptFile);
+    RUN_TEST(testFailedWriteKeepsSnapshot);
+    return 0;
+}
@@ -1,7 +1,9 @@
 #include "../splayTree.h"
 
 #include "testUtility.h"
+#include <algorithm>
 #include <cassert>
+#include <numeric>
 
 using namespace trees;
 
@@ -194,6 +196,8 @@ void testRank() {
     ASSERT_EQUALS(9, tree.rank_weight(4));
     ASSERT_EQUALS(4, tree.getRoot());
 
+    ASSERT_EQUALS(4, tree.rank(6));
+    ASSERT_EQUALS(6, tree.getRoot());
     ASSERT_EQUALS(2, tree.rank_weight(2));
     ASSERT_EQUALS(15, tree.rank_weight(6));
     ASSERT_EQUALS(5, tree.rank_weight(3));
@@ -208,11 +212,307 @@ void testRank() {
     assert(thrown);
 }
 
+typedef BST<int, int> IntTree;
+
+void testBuildFromSorted() {
+    int data[7] = {1, 2, 3, 4, 5, 6, 7};
+    Splay<int, int> tree;
+    tree.insert(100, 100, 100);
+    tree.buildFromSorted(data, data, data, 7);
+    ASSERT_EQUALS(7, tree.getSize());
+    ASSERT_EQUALS(4, tree.getRoot()); //balanced
+    ASSERT_THROWS(IntTree::KeyNotFound, tree.find(100));
+    ASSERT_EQUALS(5, tree.select(5));
+    ASSERT_EQUALS(21, tree.rank_weight(6));
+    ASSERT_NO_THROW(tree.remove(4));
+    ASSERT_NO_THROW(tree.insert(8, 8, 8));
+    ASSERT_EQUALS(7, tree.getSize());
+
+    int unsorted[3] = {1, 3, 2};
+    ASSERT_THROWS(IntTree::InvalidInput,
+                  tree.buildFromSorted(unsorted, unsorted, unsorted, 3));
+    ASSERT_EQUALS(7, tree.getSize());
+    tree.buildFromSorted(data, data, data, 0);
+    ASSERT_EQUALS(0, tree.getSize());
+}
+
+class IsOdd {
+public:
+    bool operator()(int x) const {
+        return x % 2 != 0;
+    }
+};
+
+void testIterators() {
+    Splay<int, int> tree;
+    ASSERT_TRUE(tree.begin() == tree.end());
+    int keys[8] = {50, 20, 80, 10, 30, 70, 90, 60};
+    for (int i = 0; i < 8; i++)
+        tree.insert(keys[i] * 2, keys[i], 1);
+
+    int expected[8] = {10, 20, 30, 50, 60, 70, 80, 90};
+    int count = 0;
+    for (IntTree::Iterator it = tree.begin(); it != tree.end(); ++it) {
+        ASSERT_EQUALS(expected[count], it.key());
+        ASSERT_EQUALS(expected[count] * 2, *it);
+        count++;
+    }
+    ASSERT_EQUALS(8, count);
+    IntTree::Iterator last = tree.end();
+    for (int i = 7; i >= 0; i--)
+        ASSERT_EQUALS(expected[i], (--last).key());
+    ASSERT_TRUE(last == tree.begin());
+
+    //iterators point to nodes, a splay in the middle doesn't break them
+    IntTree::Iterator it = tree.begin();
+    ++it;
+    tree.find(90);
+    ASSERT_EQUALS(30, (++it).key());
+
+    //standard algorithms
+    ASSERT_EQUALS(std::accumulate(expected, expected + 8, 0) * 2,
+                  std::accumulate(tree.begin(), tree.end(), 0));
+    ASSERT_TRUE(std::find(tree.begin(), tree.end(), 140) != tree.end());
+    ASSERT_TRUE(std::find_if(tree.begin(), tree.end(), IsOdd()) == tree.end());
+    ASSERT_EQUALS(8, (int) std::distance(tree.begin(), tree.end()));
+
+    const IntTree& read_only = tree;
+    IntTree::ConstIterator first = tree.begin();
+    ASSERT_TRUE(first == read_only.begin());
+    ASSERT_EQUALS(180, *std::max_element(read_only.begin(), read_only.end()));
+#if __cplusplus >= 201103L
+    int sum = 0;
+    for (int& data : tree) {
+        data++;
+        sum += data;
+    }
+    ASSERT_EQUALS(std::accumulate(expected, expected + 8, 0) * 2 + 8, sum);
+#endif
+}
+
+void testPrefixQueries() {
+    Splay<int, int> tree;
+    ASSERT_EQUALS(0, tree.prefixWeight(0));
+    ASSERT_EQUALS(0, tree.countLess(5));
+    int keys[8] = {50, 20, 80, 10, 30, 70, 90, 60};
+    for (int i = 0; i < 8; i++)
+        tree.insert(keys[i], keys[i], keys[i] / 10);
+
+    //sorted: 10 20 30 50 60 70 80 90, values are key / 10
+    int prefix = 0;
+    int sorted[8] = {10, 20, 30, 50, 60, 70, 80, 90};
+    for (int k = 0; k <= 8; k++) {
+        ASSERT_EQUALS(prefix, tree.prefixWeight(k));
+        if (k < 8)
+            prefix += sorted[k] / 10;
+    }
+    ASSERT_THROWS(IntTree::InvalidInput, tree.prefixWeight(9));
+    ASSERT_THROWS(IntTree::InvalidInput, tree.prefixWeight(-1));
+
+    ASSERT_EQUALS(0, tree.countLess(10));
+    ASSERT_EQUALS(1, tree.countLess(11));
+    ASSERT_EQUALS(3, tree.countLess(50));
+    ASSERT_EQUALS(8, tree.countLess(1000));
+    ASSERT_EQUALS(8, tree.getSize());
+    ASSERT_EQUALS(70, tree.select(6));
+
+    tree.update(30, 31, 100);
+    ASSERT_EQUALS(31, tree.getRoot());
+    ASSERT_EQUALS(103, tree.prefixWeight(3));
+    ASSERT_THROWS(IntTree::KeyNotFound, tree.update(31, 31, 1));
+}
+
+void testAssignment() {
+    Splay<int, int> tree;
+    Splay<int, int> other;
+    for (int i = 0; i < 5; i++)
+        tree.insert(i, i, i);
+    other.insert(100, 100, 100);
+    other = tree;
+    ASSERT_EQUALS(5, other.getSize());
+    ASSERT_THROWS(IntTree::KeyNotFound, other.find(100));
+    ASSERT_EQUALS(10, other.prefixWeight(5));
+    other.remove(0);
+    ASSERT_EQUALS(5, tree.getSize());
+    other = other;
+    ASSERT_EQUALS(4, other.getSize());
+}
+
+/**orders int keys from the largest down, counting the calls */
+class Descending {
+public:
+    static int calls;
+
+    int operator()(int first, int second) const {
+        calls++;
+        return second - first;
+    }
+};
+
+int Descending::calls = 0;
+
+typedef Splay<int, int, Descending> DescendingTree;
+
+void testComparator() {
+    DescendingTree tree;
+    int keys[7] = {4, 2, 6, 1, 3, 5, 7};
+    for (int i = 0; i < 7; i++)
+        tree.insert(keys[i] * 10, keys[i], keys[i]);
+    ASSERT_EQUALS(7, tree.select(1));
+    ASSERT_EQUALS(1, tree.select(7));
+    ASSERT_EQUALS(7 + 6 + 5, tree.prefixWeight(3));
+    ASSERT_EQUALS(2, tree.countLess(5));
+    int expected = 7;
+    for (DescendingTree::Iterator it = tree.begin();
+         it != tree.end(); ++it)
+        ASSERT_EQUALS(expected-- * 10, *it);
+
+    //one comparison per visited node
+    int sorted[7] = {7, 6, 5, 4, 3, 2, 1};
+    tree.buildFromSorted(sorted, sorted, sorted, 7);
+    Descending::calls = 0;
+    tree.find(1); //a leaf of the balanced tree, three levels down
+    ASSERT_EQUALS(3, Descending::calls);
+    ASSERT_THROWS(DescendingTree::InvalidInput,
+                  tree.buildFromSorted(keys, keys, keys, 7));
+}
+
+void testAbsorb() {
+    Splay<int, int> tree;
+    Splay<int, int> other;
+    for (int i = 0; i < 100; i++) {
+        if (i % 4 == 1)
+            tree.insert(i, i, 1);
+        else
+            other.insert(i, i, 1);
+    }
+    tree.absorb(other);
+    ASSERT_EQUALS(100, tree.getSize());
+    ASSERT_EQUALS(0, other.getSize());
+    ASSERT_TRUE(other.begin() == other.end());
+    int expected = 0;
+    for (IntTree::Iterator it = tree.begin(); it != tree.end(); ++it)
+        ASSERT_EQUALS(expected++, it.key());
+    ASSERT_EQUALS(40, tree.select(41));
+    ASSERT_EQUALS(30, tree.prefixWeight(30));
+    ASSERT_EQUALS(51, tree.countLess(51));
+
+    //a common key changes neither tree
+    other.insert(7, 7, 1);
+    other.insert(500, 500, 1);
+    ASSERT_THROWS(IntTree::KeyAlreadyExist, tree.absorb(other));
+    ASSERT_EQUALS(100, tree.getSize());
+    ASSERT_EQUALS(2, other.getSize());
+    other.remove(7);
+    tree.absorb(other);
+    ASSERT_EQUALS(101, tree.getSize());
+    ASSERT_EQUALS(500, tree.findMax());
+    tree.absorb(tree);
+    tree.absorb(other);
+    ASSERT_EQUALS(101, tree.getSize());
+    other.absorb(tree);
+    ASSERT_EQUALS(101, other.getSize());
+    ASSERT_NO_THROW(other.remove(50));
+}
+
+typedef Splay<int, int> IntSplay;
+
+void testVersion() {
+    IntSplay tree;
+    unsigned long version = tree.getVersion();
+    tree.insert(1, 1, 1);
+    tree.insert(2, 2, 2);
+    ASSERT_TRUE(version != tree.getVersion());
+    version = tree.getVersion();
+    tree.find(1);
+    tree.select(2);
+    tree.prefixWeight(1);
+    ASSERT_THROWS(IntSplay::KeyAlreadyExist, tree.insert(1, 1, 1));
+    ASSERT_EQUALS(version, tree.getVersion());
+    tree.update(1, 5, 5);
+    ASSERT_TRUE(version != tree.getVersion());
+    version = tree.getVersion();
+    tree.remove(2);
+    ASSERT_TRUE(version != tree.getVersion());
+    version = tree.getVersion();
+    IntSplay other;
+    other.insert(3, 3, 3);
+    unsigned long other_version = other.getVersion();
+    tree.absorb(other);
+    ASSERT_TRUE(version != tree.getVersion());
+    ASSERT_TRUE(other_version != other.getVersion());
+    version = tree.getVersion();
+    tree = other;
+    ASSERT_TRUE(version != tree.getVersion());
+}
+
+struct Record {
+    int id;
+    int payload;
+};
+
+class RecordId {
+public:
+    int operator()(const Record& record) const {
+        return record.id;
+    }
+};
+
+typedef Splay<Record, int, ThreeWayCompare<int>,
+        ExtractedKey<Record, int, RecordId> > RecordTree;
+
+static Record makeRecord(int id) {
+    Record record = {id, id * 10};
+    return record;
+}
+
+void testExtractedKey() {
+    RecordTree tree;
+    RecordTree other;
+    for (int i = 0; i < 50; i++) {
+        if (i % 3 == 0)
+            tree.insert(makeRecord(i), i, i);
+        else
+            other.insert(makeRecord(i), i, i);
+    }
+    ASSERT_THROWS(RecordTree::KeyAlreadyExist,
+                  tree.insert(makeRecord(0), 0, 0));
+    ASSERT_EQUALS(90, tree.find(9).payload);
+    tree.absorb(other);
+    ASSERT_EQUALS(50, tree.getSize());
+    int expected = 0;
+    for (RecordTree::Iterator it = tree.begin(); it != tree.end(); ++it) {
+        ASSERT_EQUALS(expected, it.key());
+        ASSERT_EQUALS(expected, (*it).id);
+        expected++;
+    }
+
+    //the root has two sons, its successor's data takes its place
+    tree.find(25);
+    ASSERT_EQUALS(25, tree.remove(25).id);
+    ASSERT_THROWS(RecordTree::KeyNotFound, tree.find(25));
+    ASSERT_EQUALS(26, tree.select(26));
+    ASSERT_EQUALS(28, tree.rank(28));
+    ASSERT_EQUALS(49 * 50 / 2 - 25, tree.prefixWeight(49));
+    tree.update(26, makeRecord(26), 0);
+    ASSERT_EQUALS(tree.rank_weight(24), tree.rank_weight(26));
+    ASSERT_EQUALS(0, tree.findMin().id);
+    ASSERT_EQUALS(49, tree.findMax().id);
+}
+
 int main() {
     RUN_TEST(testInsert);
     RUN_TEST(testFind);
     RUN_TEST(testRemove);
     RUN_TEST(testSelect);
     RUN_TEST(testRank);
+    RUN_TEST(testVersion);
+    RUN_TEST(testBuildFromSorted);
+    RUN_TEST(testIterators);
+    RUN_TEST(testPrefixQueries);
+    RUN_TEST(testAssignment);
+    RUN_TEST(testComparator);
+    RUN_TEST(testAbsorb);
+    RUN_TEST(testExtractedKey);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,68 @@
+/**UNROLLED LIST BENCHMARK
+ * times a full scan with find() over List, UnrolledList and a plain array of
+ * the same ints, for 10^3..10^6 items.
+ * build: g++ -O2 -DNDEBUG unrolledListBench.cpp
+ * usage: unrolledListBench */
+
+#include "../list.h"
+#include "../unrolledList.h"
+
+#include <stdio.h>
+#include <time.h>
+
+/**matches nothing, so find() scans the whole list */
+class IsNegative {
+public:
+    bool operator()(int value) const {
+        return value < 0;
+    }
+};
+
+double secondsSince(clock_t start) {
+    return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main() {
+    const int scanned = 10000000; //items scanned per measurement
+    printf("%10s %14s %14s %14s\n", "items", "List (ns)", "Unrolled (ns)",
+           "array (ns)");
+    for (int n = 1000; n <= 1000000; n *= 10) {
+        List<int> list;
+        UnrolledList<int> unrolled;
+        int* array = new int[n];
+        for (int i = 0; i < n; i++) {
+            list.insert(i);
+            unrolled.insert(i);
+            array[i] = i;
+        }
+        int rounds = scanned / n;
+        int misses = 0;
+
+        clock_t start = clock();
+        for (int r = 0; r < rounds; r++)
+            misses += list.find(IsNegative()) == list.end();
+        double list_time = secondsSince(start);
+
+        start = clock();
+        for (int r = 0; r < rounds; r++)
+            misses += unrolled.find(IsNegative()) == unrolled.end();
+        double unrolled_time = secondsSince(start);
+
+        start = clock();
+        for (int r = 0; r < rounds; r++) {
+            int i = 0;
+            while (i < n && !IsNegative()(array[i]))
+                i++;
+            misses += i == n;
+        }
+        double array_time = secondsSince(start);
+
+        if (misses != 3 * rounds)
+            printf("unexpected match\n");
+        double items = (double) rounds * n / 1e9;
+        printf("%10d %14.3f %14.3f %14.3f\n", n, list_time / items,
+               unrolled_time / items, array_time / items);
+        delete[] array;
+    }
+    return 0;
+}
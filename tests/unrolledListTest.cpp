@@ -0,0 +1,180 @@
+#include "../unrolledList.h"
+#include "../list.h"
+
+#include "testUtility.h"
+#include <cassert>
+
+/**a type without a default constructor, that counts its live copies */
+class Item {
+    int value;
+public:
+    static int live;
+
+    explicit Item(int value) : value(value) {
+        live++;
+    }
+
+    Item(const Item& item) : value(item.value) {
+        live++;
+    }
+
+    Item& operator=(const Item& item) {
+        value = item.value;
+        return *this;
+    }
+
+    ~Item() {
+        live--;
+    }
+
+    int getValue() const {
+        return value;
+    }
+
+    bool operator==(const Item& item) const {
+        return value == item.value;
+    }
+
+    bool operator!=(const Item& item) const {
+        return !(*this == item);
+    }
+};
+
+int Item::live = 0;
+
+class Equals {
+    int value;
+public:
+    explicit Equals(int value) : value(value) {}
+
+    bool operator()(const Item& item) const {
+        return item.getValue() == value;
+    }
+};
+
+typedef UnrolledList<Item, 4> SmallList;
+
+/**checks list holds the same values as reference, forwards and backwards */
+bool sameAs(const SmallList& list, const List<int>& reference) {
+    if (list.getSize() != reference.getSize())
+        return false;
+    SmallList::Iterator it = list.begin();
+    List<int>::Iterator expected = reference.begin();
+    for (; it != list.end(); ++it, ++expected) {
+        if ((*it).getValue() != *expected)
+            return false;
+    }
+    if (list.getSize() == 0)
+        return true;
+    SmallList::Iterator last = list.end();
+    --last;
+    for (int i = list.getSize() - 1; i > 0; i--) {
+        --expected;
+        if ((*last).getValue() != *expected)
+            return false;
+        --last;
+    }
+    return last == list.begin();
+}
+
+void testEmpty() {
+    SmallList list;
+    ASSERT_EQUALS(0, list.getSize());
+    ASSERT_TRUE(list.begin() == list.end());
+#ifndef NDEBUG //unchecked in release builds
+    ASSERT_THROWS(SmallList::ElementNotFound, *list.begin());
+#endif
+    ASSERT_THROWS(SmallList::ElementNotFound, list.remove(list.begin()));
+    ASSERT_TRUE(list.find(Equals(1)) == list.end());
+}
+
+void testInsertRemove() {
+    SmallList list;
+    for (int i = 0; i < 10; i++)
+        list.insert(Item(i * 2));
+    //inserts into full chunks, splitting them
+    for (int i = 0; i < 10; i++)
+        list.insert(Item(i * 2 + 1), list.find(Equals(i * 2 + 2)));
+    ASSERT_EQUALS(20, list.getSize());
+    int expected = 0;
+    for (SmallList::Iterator it = list.begin(); it != list.end(); ++it)
+        ASSERT_EQUALS(expected++, (*it).getValue());
+
+    SmallList::Iterator it = list.find(Equals(13));
+    ASSERT_EQUALS(13, (*it).getValue());
+    list.remove(it);
+    ASSERT_TRUE(list.find(Equals(13)) == list.end());
+    ASSERT_EQUALS(19, list.getSize());
+
+    SmallList other;
+    ASSERT_THROWS(SmallList::ElementNotFound, other.remove(list.begin()));
+    ASSERT_THROWS(SmallList::ElementNotFound,
+                  other.insert(Item(5), list.begin()));
+
+    SmallList copy(list);
+    ASSERT_TRUE(copy == list);
+    copy.remove(copy.begin());
+    ASSERT_TRUE(copy != list);
+    copy = list;
+    ASSERT_TRUE(copy == list);
+}
+
+void testAgainstList() {
+    SmallList list;
+    List<int> reference;
+    unsigned int seed = 3;
+    for (int op = 0; op < 5000; op++) {
+        seed = seed * 1103515245u + 12345u;
+        int value = (int) ((seed >> 16) % 100);
+        if (reference.getSize() > 0 && (seed >> 8) % 3 == 0) {
+            //remove the first item with value, or the first item
+            List<int>::Iterator found = reference.begin();
+            while (found != reference.end() && *found != value)
+                ++found;
+            if (found == reference.end())
+                value = *reference.begin();
+            List<int>::Iterator target = reference.begin();
+            while (*target != value)
+                ++target;
+            reference.remove(target);
+            list.remove(list.find(Equals(value)));
+        } else {
+            //insert before the first item larger than value
+            List<int>::Iterator target = reference.begin();
+            SmallList::Iterator position = list.begin();
+            while (target != reference.end() && *target <= value) {
+                ++target;
+                ++position;
+            }
+            reference.insert(value, target);
+            list.insert(Item(value), position);
+        }
+        if (op % 97 == 0)
+            ASSERT_TRUE(sameAs(list, reference));
+    }
+    ASSERT_TRUE(sameAs(list, reference));
+    while (list.getSize() > 0)
+        list.remove(list.begin());
+    ASSERT_TRUE(list.begin() == list.end());
+}
+
+void testNoLeaks() {
+    {
+        SmallList list;
+        for (int i = 0; i < 100; i++)
+            list.insert(Item(i));
+        for (int i = 0; i < 100; i += 3)
+            list.remove(list.find(Equals(i)));
+        SmallList copy(list);
+        ASSERT_EQUALS(66 * 2, Item::live);
+    }
+    ASSERT_EQUALS(0, Item::live);
+}
+
+int main() {
+    RUN_TEST(testEmpty);
+    RUN_TEST(testInsertRemove);
+    RUN_TEST(testAgainstList);
+    RUN_TEST(testNoLeaks);
+    return 0;
+}
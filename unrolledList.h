@@ -0,0 +1,508 @@
+#ifndef LIST_UNROLLEDLIST_H
+#define LIST_UNROLLEDLIST_H
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+
+/**default number of items a chunk holds */
+#define UNROLLED_LIST_CHUNK_SIZE 32
+
+/*---------------------------------------------------------------------------*/
+/* UnrolledList Class */
+/*---------------------------------------------------------------------------*/
+
+/** generic unrolled doubly list class, with the interface of List:
+ *  Assumptions on T: T has copy constructor T(T)
+ *                    assignment operator=
+ *             operator==: operator== and != require operator ==, != of T.
+ *
+ *  Instead of a node per item, each node (chunk) holds up to ChunkSize items
+ *  in an array, next to each other. Iterating and find() go over the arrays,
+ *  so they touch one heap node per ChunkSize items instead of one per item.
+ *  The chunks are circular around a sentinel that is embedded in the list
+ *  object, like the one of List.
+ *
+ *  A chunk that fills up is split in two halves, a chunk that empties is
+ *  freed, and a chunk that falls under a quarter full is merged with the
+ *  next chunk when both fit in half a chunk.
+ *
+ *  Iterator stability (unlike List, items move when their chunk changes):
+ *   - insert invalidates the iterators to items of the chunk it inserts
+ *     into (or splits). Iterators to other chunks, and end(), stay valid.
+ *   - remove invalidates the iterators to items of the chunk it removes
+ *     from, and of the next chunk (it may be merged). Other iterators, and
+ *     end(), stay valid.
+ *   - a valid iterator always points to the same item.
+ *
+ *  ChunkSize must be at least 4.
+ *
+ *  Exceptions: elementNotFound */
+template<class T, int ChunkSize = UNROLLED_LIST_CHUNK_SIZE>
+class UnrolledList {
+    /**fails to compile for a ChunkSize under 4 */
+    typedef char ChunkSizeIsAtLeast4[ChunkSize >= 4 ? 1 : -1];
+
+    class ChunkBase;
+    class Chunk;
+
+    /**the links of a chunk, and the sentinel (no items) */
+    class ChunkBase {
+    public:
+        ChunkBase* previous;
+        ChunkBase* next;
+
+        /**constructor- creates a chunk linked to itself */
+        ChunkBase() : previous(this), next(this) {}
+    };
+
+    ChunkBase header;
+    int size;
+
+    /**links chunk between previous and previous's next */
+    static void linkAfter(ChunkBase* previous, ChunkBase* chunk);
+    /**unlinks chunk from its neighbours */
+    static void unlink(ChunkBase* chunk);
+
+    /**SPLIT
+     * moves the upper half of a full chunk to a new chunk after it */
+    void split(Chunk* chunk);
+
+    /**MERGE NEXT
+     * moves the items of the next chunk into chunk and frees the next chunk,
+     * if there is a next chunk and both fit in half a chunk */
+    void mergeNext(Chunk* chunk);
+
+    /**removes and deletes all the items */
+    void clear();
+
+public:
+    /**constructs a new empty list */
+    UnrolledList();
+
+    /**copy consturctor
+     * constructs a copy of the given list, with full chunks */
+    UnrolledList(const UnrolledList& list);
+
+    /**destructor
+     * destroy a list and all it's content */
+    ~UnrolledList();
+
+    /**assignment operator
+     * destroy the old list and assign it to be a copy of the source list
+     * @return a refernce to the new assigned list */
+    UnrolledList& operator=(const UnrolledList& list);
+
+    /**a class that implementing an internal iterator for the list */
+    class Iterator;
+
+    /**@return an iterator to the first item, or end() if the list is empty */
+    Iterator begin() const;
+
+    /**@return an iterator to the end of the list (the sentinel) */
+    Iterator end() const;
+
+    /**@return the number of items in the list */
+    int getSize() const;
+
+    /**insert a copy of data before the given iterator. If the iterator points
+     * to the end of the list the new item will be inserted to the end.
+     * @Exceptions: ElementNotFound- the iterator point to a different list */
+    void insert(const T& data, Iterator iterator);
+    /**insert a copy of data to the end of the list */
+    void insert(const T& data);
+
+    /**removes the item the iterator points to from the list
+     * @Exceptions: ElementNotFound - the list is empty or the iterator is
+     * invalid: points to a different list or doesn't point to a valid item */
+    void remove(Iterator iterator);
+
+    /**finds the first item for which predicate returns true
+     * @tparam Predicate - Function object that get one parameter and return true
+     *                     or false
+     * @return iterator to the first item that apply to predicate. If none exist
+     *         iterator to the end of the list will be returned */
+    template<class Predicate>
+    Iterator find(const Predicate& predicate) const;
+
+    /**compare operators: lists are equal if they contain the same values in
+     * the same order, regardless of how the items are split into chunks */
+    bool operator==(const UnrolledList& list) const;
+    bool operator!=(const UnrolledList& list) const;
+
+    class ElementNotFound : public std::runtime_error {
+    public:
+        ElementNotFound() : std::runtime_error("Element not found") {}
+    };
+};
+
+/*---------------------------------------------------------------------------*/
+/* Chunk Class*/
+/*---------------------------------------------------------------------------*/
+
+/**a node of the list: an array of up to ChunkSize items. Only the first count
+ * items are constructed, T needs no default constructor. */
+template<class T, int ChunkSize>
+class UnrolledList<T, ChunkSize>::Chunk :
+        public UnrolledList<T, ChunkSize>::ChunkBase {
+    /**raw storage for the items, aligned for any built in type */
+    union Storage {
+        char bytes[ChunkSize * sizeof(T)];
+        long double align_float;
+        long long align_integer;
+        void* align_pointer;
+    };
+
+    Storage storage;
+
+public:
+    int count;
+
+    Chunk() : ChunkBase(), count(0) {}
+
+    ~Chunk() {
+        for (int i = 0; i < count; i++) {
+            items()[i].~T();
+        }
+    }
+
+    T* items() {
+        return reinterpret_cast<T*>(storage.bytes);
+    }
+
+    /**inserts a copy of data at index, moving the items from index on one
+     * place up. The chunk must not be full. */
+    void insertAt(int index, const T& data) {
+        assert(count < ChunkSize && index >= 0 && index <= count);
+        T* array = items();
+        if (index == count) {
+            new(array + count) T(data);
+            count++;
+            return;
+        }
+        new(array + count) T(array[count - 1]);
+        count++;
+        for (int i = count - 2; i > index; i--) {
+            array[i] = array[i - 1];
+        }
+        array[index] = data;
+    }
+
+    /**removes the item at index, moving the items after it one place down */
+    void removeAt(int index) {
+        assert(index >= 0 && index < count);
+        T* array = items();
+        for (int i = index; i < count - 1; i++) {
+            array[i] = array[i + 1];
+        }
+        array[count - 1].~T();
+        count--;
+    }
+
+    /**copies the items [first, count) of source to the end of this chunk,
+     * and removes them from source */
+    void takeFrom(Chunk* source, int first) {
+        assert(count + source->count - first <= ChunkSize);
+        for (int i = first; i < source->count; i++) {
+            new(items() + count) T(source->items()[i]);
+            count++;
+        }
+        while (source->count > first) {
+            source->removeAt(source->count - 1);
+        }
+    }
+};
+
+/*---------------------------------------------------------------------------*/
+/*Iterator Class*/
+/*---------------------------------------------------------------------------*/
+
+/**an iterator to an item: the chunk that holds it and its index in the
+ * chunk. At the end of the list it points to the sentinel, index 0. */
+template<class T, int ChunkSize>
+class UnrolledList<T, ChunkSize>::Iterator {
+    const UnrolledList* list;
+    ChunkBase* chunk;
+    int index;
+
+    Iterator(const UnrolledList* list, ChunkBase* chunk, int index) :
+            list(list), chunk(chunk), index(index) {}
+
+    friend class UnrolledList;
+
+public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T* pointer;
+    typedef T& reference;
+
+    /**creates a singular iterator, that may only be assigned to */
+    Iterator() : list(NULL), chunk(NULL), index(0) {}
+
+    /**Dereference operator
+     * @return the item the iterator points to
+     * @Exceptions: ElementNotFound - debug builds (without NDEBUG), the
+     *              iterator points to the end. Undefined in release builds */
+    T& operator*() const {
+#ifndef NDEBUG
+        if (chunk == &list->header) {
+            throw ElementNotFound();
+        }
+#endif
+        return static_cast<Chunk*>(chunk)->items()[index];
+    }
+
+    T* operator->() const {
+        return &**this;
+    }
+
+    /**advance to the next item. At the end of the list it stays there. */
+    Iterator& operator++() {
+        if (chunk == &list->header) {
+            return *this;
+        }
+        if (++index == static_cast<Chunk*>(chunk)->count) {
+            chunk = chunk->next;
+            index = 0;
+        }
+        return *this;
+    }
+
+    Iterator operator++(int) {
+        Iterator result = *this;
+        ++*this;
+        return result;
+    }
+
+    /**move back to the previous item. At the first item it stays there. */
+    Iterator& operator--() {
+        if (index > 0) {
+            index--;
+        } else if (chunk->previous != &list->header) {
+            chunk = chunk->previous;
+            index = static_cast<Chunk*>(chunk)->count - 1;
+        }
+        return *this;
+    }
+
+    Iterator operator--(int) {
+        Iterator result = *this;
+        --*this;
+        return result;
+    }
+
+    /**iterators are equal if they belong to the same list and point to the
+     * same item (or both to the end) */
+    bool operator==(const Iterator& iterator) const {
+        return list == iterator.list && chunk == iterator.chunk &&
+               index == iterator.index;
+    }
+
+    bool operator!=(const Iterator& iterator) const {
+        return !(*this == iterator);
+    }
+};
+
+/*---------------------------------------------------------------------------*/
+/* UnrolledList Functions */
+/*---------------------------------------------------------------------------*/
+
+template<class T, int ChunkSize>
+UnrolledList<T, ChunkSize>::UnrolledList() : header(), size(0) {
+}
+
+template<class T, int ChunkSize>
+UnrolledList<T, ChunkSize>::UnrolledList(const UnrolledList& list) :
+        header(), size(0) {
+    try {
+        for (Iterator it = list.begin(); it != list.end(); it++) {
+            insert(*it);
+        }
+    } catch (...) {
+        clear();
+        throw;
+    }
+}
+
+template<class T, int ChunkSize>
+UnrolledList<T, ChunkSize>::~UnrolledList() {
+    clear();
+}
+
+template<class T, int ChunkSize>
+UnrolledList<T, ChunkSize>&
+UnrolledList<T, ChunkSize>::operator=(const UnrolledList& list) {
+    if (this == &list) {
+        return *this;
+    }
+    clear();
+    for (Iterator it = list.begin(); it != list.end(); it++) {
+        insert(*it);
+    }
+    return *this;
+}
+
+template<class T, int ChunkSize>
+void UnrolledList<T, ChunkSize>::clear() {
+    ChunkBase* current = header.next;
+    while (current != &header) {
+        ChunkBase* next = current->next;
+        delete static_cast<Chunk*>(current);
+        current = next;
+    }
+    header.next = &header;
+    header.previous = &header;
+    size = 0;
+}
+
+template<class T, int ChunkSize>
+void UnrolledList<T, ChunkSize>::linkAfter(ChunkBase* previous,
+                                           ChunkBase* chunk) {
+    ChunkBase* next = previous->next;
+    chunk->previous = previous;
+    chunk->next = next;
+    previous->next = chunk;
+    next->previous = chunk;
+}
+
+template<class T, int ChunkSize>
+void UnrolledList<T, ChunkSize>::unlink(ChunkBase* chunk) {
+    chunk->previous->next = chunk->next;
+    chunk->next->previous = chunk->previous;
+}
+
+template<class T, int ChunkSize>
+void UnrolledList<T, ChunkSize>::split(Chunk* chunk) {
+    assert(chunk->count == ChunkSize);
+    Chunk* upper = new Chunk();
+    try {
+        upper->takeFrom(chunk, ChunkSize / 2);
+    } catch (...) {
+        delete upper;
+        throw;
+    }
+    linkAfter(chunk, upper);
+}
+
+template<class T, int ChunkSize>
+void UnrolledList<T, ChunkSize>::mergeNext(Chunk* chunk) {
+    if (chunk->next == &header) {
+        return;
+    }
+    Chunk* next = static_cast<Chunk*>(chunk->next);
+    if (chunk->count + next->count > ChunkSize / 2) {
+        return;
+    }
+    chunk->takeFrom(next, 0);
+    unlink(next);
+    delete next;
+}
+
+template<class T, int ChunkSize>
+typename UnrolledList<T, ChunkSize>::Iterator
+UnrolledList<T, ChunkSize>::begin() const {
+    return Iterator(this, header.next, 0);
+}
+
+template<class T, int ChunkSize>
+typename UnrolledList<T, ChunkSize>::Iterator
+UnrolledList<T, ChunkSize>::end() const {
+    return Iterator(this, const_cast<ChunkBase*>(&header), 0);
+}
+
+template<class T, int ChunkSize>
+int UnrolledList<T, ChunkSize>::getSize() const {
+    return size;
+}
+
+template<class T, int ChunkSize>
+void UnrolledList<T, ChunkSize>::insert(const T& data) {
+    insert(data, end());
+}
+
+template<class T, int ChunkSize>
+void UnrolledList<T, ChunkSize>::insert(const T& data, Iterator iterator) {
+    if (this != iterator.list) {
+        throw ElementNotFound();
+    }
+    Chunk* chunk;
+    int index;
+    if (iterator.chunk == &header) { //append to the last chunk
+        if (header.previous == &header ||
+            static_cast<Chunk*>(header.previous)->count == ChunkSize) {
+            linkAfter(header.previous, new Chunk());
+        }
+        chunk = static_cast<Chunk*>(header.previous);
+        index = chunk->count;
+    } else {
+        chunk = static_cast<Chunk*>(iterator.chunk);
+        index = iterator.index;
+        if (chunk->count == ChunkSize) {
+            split(chunk);
+            if (index > chunk->count) {
+                index -= chunk->count;
+                chunk = static_cast<Chunk*>(chunk->next);
+            }
+        }
+    }
+    chunk->insertAt(index, data);
+    size++;
+}
+
+template<class T, int ChunkSize>
+void UnrolledList<T, ChunkSize>::remove(Iterator iterator) {
+    if (this != iterator.list || iterator == end() || size == 0) {
+        throw ElementNotFound();
+    }
+    Chunk* chunk = static_cast<Chunk*>(iterator.chunk);
+    chunk->removeAt(iterator.index);
+    size--;
+    if (chunk->count == 0) {
+        unlink(chunk);
+        delete chunk;
+    } else if (chunk->count < ChunkSize / 4) {
+        mergeNext(chunk);
+    }
+}
+
+template<class T, int ChunkSize>
+template<class Predicate>
+typename UnrolledList<T, ChunkSize>::Iterator
+UnrolledList<T, ChunkSize>::find(const Predicate& predicate) const {
+    for (ChunkBase* chunk = header.next; chunk != &header;
+         chunk = chunk->next) {
+        T* items = static_cast<Chunk*>(chunk)->items();
+        int count = static_cast<Chunk*>(chunk)->count;
+        for (int i = 0; i < count; i++) {
+            if (predicate(items[i])) {
+                return Iterator(this, chunk, i);
+            }
+        }
+    }
+    return end();
+}
+
+template<class T, int ChunkSize>
+bool UnrolledList<T, ChunkSize>::operator==(const UnrolledList& list) const {
+    if (size != list.size) {
+        return false;
+    }
+    Iterator it1 = begin();
+    Iterator it2 = list.begin();
+    while (it1 != end()) {
+        if (*(it1++) != *(it2++)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<class T, int ChunkSize>
+bool UnrolledList<T, ChunkSize>::operator!=(const UnrolledList& list) const {
+    return !(*this == list);
+}
+
+#endif //LIST_UNROLLEDLIST_H